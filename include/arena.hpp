@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace gomoku {
+
+// Bump allocator handing out contiguous index ranges of T.
+// Storage is kept in fixed-size chunks so addresses stay stable while the
+// arena grows, and reset() just rewinds the cursor: chunks are reused by the
+// next search and no per-element destructor ever runs. T must therefore be
+// trivially destructible and is (re)initialized by the caller after allocate().
+//
+// allocate() must be serialized by the caller, but reading published elements
+// concurrently with allocate() is safe: the chunk table has a fixed size and
+// is never reallocated.
+template <typename T, int ChunkBits = 16>
+class Arena {
+public:
+    using Index = uint32_t;
+    static constexpr Index NONE = ~Index(0);
+    static constexpr size_t CHUNK_SIZE = size_t(1) << ChunkBits;
+    static constexpr size_t MAX_CHUNKS = 4096;
+
+    Arena() : chunks_(MAX_CHUNKS), num_chunks_(0), cursor_(0) {}
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    // Allocate n consecutive elements; a range never straddles two chunks
+    Index allocate(size_t n) {
+        size_t offset = cursor_ & (CHUNK_SIZE - 1);
+        if (offset != 0 && offset + n > CHUNK_SIZE) {
+            // Skip the tail of the current chunk
+            cursor_ += CHUNK_SIZE - offset;
+        }
+        size_t chunk = cursor_ >> ChunkBits;
+        if (chunk >= num_chunks_) {
+            if (chunk >= MAX_CHUNKS) throw std::bad_alloc();
+            chunks_[num_chunks_++].reset(new T[CHUNK_SIZE]);
+        }
+        Index first = static_cast<Index>(cursor_);
+        cursor_ += n;
+        return first;
+    }
+
+    T& operator[](Index idx) {
+        return chunks_[idx >> ChunkBits][idx & (CHUNK_SIZE - 1)];
+    }
+    const T& operator[](Index idx) const {
+        return chunks_[idx >> ChunkBits][idx & (CHUNK_SIZE - 1)];
+    }
+
+    T* ptr(Index idx) { return &(*this)[idx]; }
+    const T* ptr(Index idx) const { return &(*this)[idx]; }
+
+    // O(1) teardown: keep the chunks, forget their contents
+    void reset() { cursor_ = 0; }
+
+    void swap(Arena& other) {
+        chunks_.swap(other.chunks_);
+        std::swap(num_chunks_, other.num_chunks_);
+        std::swap(cursor_, other.cursor_);
+    }
+    
+    size_t size() const { return cursor_; }
+    size_t capacity() const { return num_chunks_ * CHUNK_SIZE; }
+
+private:
+    std::vector<std::unique_ptr<T[]>> chunks_;
+    size_t num_chunks_;
+    size_t cursor_;
+};
+
+} // namespace gomoku
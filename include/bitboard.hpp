@@ -0,0 +1,133 @@
+#pragma once
+
+#include "types.hpp"
+
+namespace gomoku {
+
+// 15x15 bitboard stored as four 64-bit words in a padded 16-wide layout:
+// cell (x, y) is bit y * 16 + x. Column 15 and row 15 are padding and are
+// kept clear, so word-wide shifts only need one mask to stop stones from
+// wrapping around a row edge.
+//
+// The public interface takes cell indices (to_index(x, y)) like the rest of
+// the engine; the padded bit position is an internal detail.
+class BitBoard {
+public:
+    static constexpr int WORDS = 4;
+    static constexpr int STRIDE = 16;
+
+    constexpr BitBoard() : w_{0, 0, 0, 0} {}
+
+    static BitBoard single(int idx) { BitBoard r; r.set(idx); return r; }
+
+    static constexpr int bit_of(int idx) { return idx + idx / BOARD_SIZE; }
+    static constexpr int cell_of(int bit) { return bit - (bit >> 4); }
+
+    // Single-cell operations
+    void set(int idx) { int b = bit_of(idx); w_[b >> 6] |= uint64_t(1) << (b & 63); }
+    void reset(int idx) { int b = bit_of(idx); w_[b >> 6] &= ~(uint64_t(1) << (b & 63)); }
+    bool test(int idx) const { int b = bit_of(idx); return (w_[b >> 6] >> (b & 63)) & 1; }
+    bool operator[](int idx) const { return test(idx); }
+
+    // Whole-board operations
+    void reset() { w_[0] = w_[1] = w_[2] = w_[3] = 0; }
+    bool none() const { return (w_[0] | w_[1] | w_[2] | w_[3]) == 0; }
+    bool any() const { return !none(); }
+    int count() const {
+        return __builtin_popcountll(w_[0]) + __builtin_popcountll(w_[1]) +
+               __builtin_popcountll(w_[2]) + __builtin_popcountll(w_[3]);
+    }
+
+    BitBoard& operator|=(const BitBoard& o) { for (int i = 0; i < WORDS; ++i) w_[i] |= o.w_[i]; return *this; }
+    BitBoard& operator&=(const BitBoard& o) { for (int i = 0; i < WORDS; ++i) w_[i] &= o.w_[i]; return *this; }
+    BitBoard& operator^=(const BitBoard& o) { for (int i = 0; i < WORDS; ++i) w_[i] ^= o.w_[i]; return *this; }
+    BitBoard operator|(const BitBoard& o) const { BitBoard r = *this; return r |= o; }
+    BitBoard operator&(const BitBoard& o) const { BitBoard r = *this; return r &= o; }
+    BitBoard operator^(const BitBoard& o) const { BitBoard r = *this; return r ^= o; }
+
+    // Complement within the board (padding stays clear)
+    BitBoard operator~() const;
+
+    bool operator==(const BitBoard& o) const {
+        return w_[0] == o.w_[0] && w_[1] == o.w_[1] && w_[2] == o.w_[2] && w_[3] == o.w_[3];
+    }
+    bool operator!=(const BitBoard& o) const { return !(*this == o); }
+
+    // Raw shifts of the 256-bit value (0 <= n < 256); bits leaving the end
+    // are lost. A shift by whole words has no carry into the next word, and
+    // is handled apart because shifting a word by 64 is undefined.
+    BitBoard shl(int n) const {
+        BitBoard r;
+        int words = n >> 6, bits = n & 63;
+        for (int i = WORDS - 1; i >= words; --i) {
+            r.w_[i] = w_[i - words] << bits;
+            if (bits != 0 && i > words) r.w_[i] |= w_[i - words - 1] >> (64 - bits);
+        }
+        return r;
+    }
+    BitBoard shr(int n) const {
+        BitBoard r;
+        int words = n >> 6, bits = n & 63;
+        for (int i = 0; i < WORDS - words; ++i) {
+            r.w_[i] = w_[i + words] >> bits;
+            if (bits != 0 && i + words + 1 < WORDS) r.w_[i] |= w_[i + words + 1] << (64 - bits);
+        }
+        return r;
+    }
+
+    // Directional shifts by one cell; stones pushed off the board vanish
+    BitBoard east() const;
+    BitBoard west() const;
+    BitBoard south() const;
+    BitBoard north() const { return shr(STRIDE); }
+
+    // All cells within Chebyshev distance `radius` of a set cell
+    BitBoard dilate(int radius) const {
+        BitBoard r = *this;
+        for (int i = 0; i < radius; ++i) r |= r.east() | r.west();
+        for (int i = 0; i < radius; ++i) r |= r.south() | r.north();
+        return r;
+    }
+
+    // Call f(idx) for every set cell in increasing index order
+    template <typename F>
+    void for_each(F&& f) const {
+        for (int i = 0; i < WORDS; ++i) {
+            uint64_t word = w_[i];
+            while (word) {
+                int bit = (i << 6) + __builtin_ctzll(word);
+                f(cell_of(bit));
+                word &= word - 1;
+            }
+        }
+    }
+
+    // Mask of all real cells
+    static constexpr BitBoard make_valid() {
+        BitBoard r;
+        for (int y = 0; y < BOARD_SIZE; ++y) {
+            for (int x = 0; x < BOARD_SIZE; ++x) {
+                int b = y * STRIDE + x;
+                r.w_[b >> 6] |= uint64_t(1) << (b & 63);
+            }
+        }
+        return r;
+    }
+
+private:
+    uint64_t w_[WORDS];
+};
+
+inline constexpr BitBoard BOARD_MASK = BitBoard::make_valid();
+
+inline BitBoard BitBoard::operator~() const {
+    BitBoard r;
+    for (int i = 0; i < WORDS; ++i) r.w_[i] = ~w_[i] & BOARD_MASK.w_[i];
+    return r;
+}
+
+inline BitBoard BitBoard::east() const { return shl(1) & BOARD_MASK; }
+inline BitBoard BitBoard::west() const { return shr(1) & BOARD_MASK; }
+inline BitBoard BitBoard::south() const { return shl(STRIDE) & BOARD_MASK; }
+
+} // namespace gomoku
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "types.hpp"
+#include "bitboard.hpp"
 #include <vector>
 #include <string>
 
@@ -14,25 +15,56 @@ public:
     void make_move(const Move& move);
     void make_move(int x, int y);
     void unmake_move(const Move& move);
+    void unmake_to(int move_count);  // Undo moves until move_count remain
     void reset();
     
     // State queries
-    int8_t get(int x, int y) const;
-    int8_t get(int idx) const;
+    int8_t get(int x, int y) const { return cells_[to_index(x, y)]; }
+    int8_t get(int idx) const { return cells_[idx]; }
     bool is_empty(int x, int y) const;
     bool is_legal(int x, int y) const;
     bool is_legal(const Move& move) const;
     
     // Legal moves
     std::vector<Move> get_legal_moves() const;
+    void get_legal_moves(MoveList& out) const;  // Allocation-free
     int count_legal_moves() const;
     
+    // Call f(move) for every legal move in index order, without allocating
+    template <typename F>
+    void for_each_legal_move(F&& f) const {
+        for_each_legal_index([&](int idx) { f(Move(to_x(idx), to_y(idx))); });
+    }
+    
+    // Same, passing the cell index (to_index) for scans that only need that
+    template <typename F>
+    void for_each_legal_index(F&& f) const {
+        // First move - just the center
+        if (history_.empty()) {
+            f(to_index(7, 7));
+            return;
+        }
+        legal_mask_.for_each(f);
+    }
+    
     // Game state
     bool is_terminal() const { return is_terminal_; }
     GameResult get_result() const { return result_; }
     int8_t get_winner() const;
     int8_t current_player() const { return current_player_; }
     
+    // Would a stone of `player` at `move` complete five in a row?
+    bool makes_five(const Move& move, int8_t player) const;
+    
+    // Pattern window code of a cell along DIRECTIONS[dir], kept up to date
+    // by make/unmake (see PATTERN_REACH)
+    uint16_t window_code(int idx, int dir) const { return windows_[idx * 4 + dir]; }
+    uint16_t compute_window_code(int idx, int dir) const;  // From scratch
+    
+    // Zobrist key of the position (stones and side to move)
+    uint64_t hash() const { return hash_; }
+    uint64_t compute_hash() const;  // From scratch, for verification
+    
     // Move history
     const std::vector<Move>& get_history() const { return history_; }
     int move_count() const { return static_cast<int>(history_.size()); }
@@ -50,18 +82,43 @@ private:
     BitBoard white_mask_;
     BitBoard legal_mask_;
     
+    // Per-line stone masks for win detection: [player][direction][line],
+    // with bit i set when the player owns the i-th cell along that line.
+    // Lines follow DIRECTIONS: rows, columns, diagonals (x - y + 14) and
+    // anti-diagonals (x + y); the bit position along each line is x,
+    // except for columns where it is y.
+    static constexpr int NUM_LINES = 2 * BOARD_SIZE - 1;
+    std::array<std::array<std::array<uint16_t, NUM_LINES>, 4>, 2> line_masks_;
+    
+    // Window codes, indexed idx * 4 + dir; reset() loads the empty-board
+    // codes (edges marked CELL_WALL)
+    std::array<uint16_t, BOARD_CELLS * 4> windows_;
+    
     // Game state
     int8_t current_player_;
     bool is_terminal_;
     GameResult result_;
+    uint64_t hash_;
     
     // Move history for unmake
     std::vector<Move> history_;
     
+    // Undo stack: legal mask before each move, so unmake is O(1)
+    std::vector<BitBoard> legal_undo_;
+    
     // Internal methods
     void update_legal_mask(const Move& move);
+    void toggle_lines(int8_t player, int x, int y);
+    void toggle_windows(int8_t player, int x, int y);
     bool check_win(const Move& move) const;
-    int count_direction(int x, int y, int dx, int dy, int8_t player) const;
+    
+    static int player_slot(int8_t player) { return player == BLACK ? 0 : 1; }
+    static constexpr int line_index(int dir, int x, int y) {
+        return dir == 0 ? y : dir == 1 ? x : dir == 2 ? x - y + BOARD_SIZE - 1 : x + y;
+    }
+    static constexpr int line_pos(int dir, int x, int y) {
+        return dir == 1 ? y : x;
+    }
 };
 
 } // namespace gomoku
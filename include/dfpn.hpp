@@ -0,0 +1,90 @@
+#pragma once
+
+#include "board.hpp"
+#include "heuristic.hpp"
+#include "node_table.hpp"
+#include <chrono>
+#include <vector>
+
+namespace gomoku {
+
+// Outcome of one DFPNSolver::solve call
+struct DFPNResult {
+    enum Outcome { PROVEN, DISPROVEN, UNKNOWN };
+    Outcome outcome = UNKNOWN;   // PROVEN: side to move wins by threats
+    Move best;                   // First move of the proof
+    std::vector<Move> line;      // Principal line of the proof
+    uint64_t proof_size = 0;     // Distinct positions in the proof tree
+                                 // (line and size cover what the table still holds)
+    uint64_t nodes = 0;          // Positions expanded
+    double seconds = 0.0;
+};
+
+// Depth-first proof-number search (df-pn) for the side to move (the
+// attacker). Move generation follows the threat classifier:
+// - attacker (OR) nodes: only fours and threes, i.e. moves leaving a five
+//   cell or a cell making two fives; a position without one is disproven;
+// - defender (AND) nodes: the forced block of a five, or the replies that can
+//   stop a double-five cell (the cell, its five cells, the defender's fours);
+//   with no attacker threat left the attack has failed.
+// A five to block restricts either side to the block. So a proof is a win
+// by continuous threats, found without VCTSolver's depth limit and
+// dependency pruning.
+//
+// Proof and disproof numbers live in a bounded two-way transposition table
+// keyed by Zobrist hash; solved entries and entries with more work behind
+// them are kept over the rest. Entries are stamped with the solve call that
+// stored them, so starting a solve does not touch the table (as NodeTable).
+// Not thread-safe.
+class DFPNSolver {
+public:
+    // The table holds 2^table_bits entries (24 bytes each)
+    explicit DFPNSolver(int table_bits = 18);
+
+    // Solve for board's side to move within the node and time limits
+    // (0 = unlimited); board is restored before returning
+    DFPNResult solve(Board& board, uint64_t max_nodes, int time_limit_ms = 0);
+
+    size_t table_size() const { return table_.size(); }
+
+private:
+    static constexpr uint32_t INF = 100000000;
+
+    struct Entry {
+        uint64_t key = 0;
+        uint32_t pn = 0;
+        uint32_t dn = 0;
+        uint32_t work = 0;        // Nodes expanded below the entry
+        uint32_t generation = 0;  // solve call that stored it; others are empty
+    };
+
+    Heuristic heuristic_;
+    std::vector<Entry> table_;
+    uint32_t generation_;
+    uint64_t nodes_;
+    uint64_t max_nodes_;
+    int time_limit_ms_;
+    std::chrono::steady_clock::time_point deadline_;
+    bool stopped_;
+
+    // Children of the position with their initial proof/disproof numbers,
+    // or -1 with (pn, dn) set when it is decided without search; then
+    // out[0] is the side to move's five, if it has one
+    int generate(Board& board, bool or_node, Move* out, uint32_t* child_pn, uint32_t* child_dn,
+                 uint32_t& pn, uint32_t& dn);
+
+    // Search until pn >= th_pn or dn >= th_dn; returns the node's numbers
+    void mid(Board& board, bool or_node, uint32_t th_pn, uint32_t th_dn,
+             uint32_t& pn, uint32_t& dn);
+
+    // Size of the proof tree below a proven position; fills line with the
+    // first child at every node
+    uint64_t proof_tree(Board& board, bool or_node, NodeTable& seen, std::vector<Move>* line);
+
+    bool is_live(const Entry& entry) const { return entry.generation == generation_; }
+    const Entry* lookup(uint64_t key) const;
+    void store(uint64_t key, uint32_t pn, uint32_t dn, uint64_t work);
+    bool out_of_budget();
+};
+
+} // namespace gomoku
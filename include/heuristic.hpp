@@ -1,7 +1,9 @@
 #pragma once
 
 #include "board.hpp"
+#include <algorithm>
 #include <array>
+#include <functional>
 
 namespace gomoku {
 
@@ -16,6 +18,48 @@ constexpr int SCORE_TWO_CLOSED = 20;
 constexpr int SCORE_SPACE = 10;      // Per empty square around move
 constexpr int SCORE_CLUSTER = 10;    // Per nearby stone
 
+// Line pattern classes, as stored in the pattern table
+enum LineClass : uint8_t {
+    LINE_NONE,
+    LINE_TWO_CLOSED,
+    LINE_TWO_OPEN,
+    LINE_THREE_CLOSED,
+    LINE_THREE_OPEN,
+    LINE_FOUR_CLOSED,
+    LINE_FOUR_OPEN,
+    LINE_WIN
+};
+
+constexpr std::array<int, 8> LINE_CLASS_SCORE = {
+    0, SCORE_TWO_CLOSED, SCORE_TWO_OPEN, SCORE_THREE_CLOSED,
+    SCORE_THREE_OPEN, SCORE_FOUR_CLOSED, SCORE_FOUR_OPEN, SCORE_WIN
+};
+
+// Forcing moves of both colours, found in one sweep over the legal moves.
+// Each move is the first legal move in index order with that property, or
+// invalid if there is none.
+struct ThreatSummary {
+    struct Side {
+        Move five;          // Completes five
+        Move open_four;     // Makes an open four
+        Move strongest;     // Best line for this colour, if open three or better
+        LineClass strongest_class = LINE_NONE;
+        int num_fives = 0;  // Cells completing five (2+ cannot all be blocked)
+    };
+    
+    std::array<Side, 2> sides;  // [0] BLACK, [1] WHITE
+    
+    const Side& of(int8_t player) const { return sides[player == BLACK ? 0 : 1]; }
+    
+    // Record a legal move given the line classes present through it, as
+    // bit masks (1 << LineClass) per colour; call in index order
+    void add(const Move& move, uint8_t black_classes, uint8_t white_classes);
+    
+    // Move the side to move must play: its own five, else a block of the
+    // opponent's five, else its own open four. Invalid if none.
+    Move forced_move(int8_t player) const;
+};
+
 // Move with score for sorting
 struct ScoredMove {
     Move move;
@@ -34,6 +78,41 @@ struct ScoredMove {
     }
 };
 
+// Keeps the k best of a stream of scored moves in caller storage. The kept
+// moves form a min-heap whose root is the worst of them, so a candidate
+// that does not make the cut costs one comparison. Ties keep the earlier
+// candidate.
+class TopMoves {
+public:
+    TopMoves(ScoredMove* out, int k) : out_(out), k_(k), size_(0) {}
+    
+    void offer(const ScoredMove& sm) {
+        if (size_ < k_) {
+            out_[size_++] = sm;
+            std::push_heap(out_, out_ + size_, std::greater<ScoredMove>());
+        } else if (k_ > 0 && sm > out_[0]) {
+            std::pop_heap(out_, out_ + size_, std::greater<ScoredMove>());
+            out_[size_ - 1] = sm;
+            std::push_heap(out_, out_ + size_, std::greater<ScoredMove>());
+        }
+    }
+    
+    // Once k moves are kept, a candidate must beat this one to be kept
+    bool full() const { return size_ == k_; }
+    const ScoredMove& worst() const { return out_[0]; }
+    
+    // Order the kept moves best first and return how many there are
+    int finish() {
+        std::sort_heap(out_, out_ + size_, std::greater<ScoredMove>());
+        return size_;
+    }
+    
+private:
+    ScoredMove* out_;
+    int k_;
+    int size_;
+};
+
 class Heuristic {
 public:
     Heuristic();
@@ -47,25 +126,73 @@ public:
     // Get all moves sorted by score
     std::vector<ScoredMove> get_scored_moves(const Board& board) const;
     
-    // Quick check for immediate wins/threats
+    // The k best moves, best first, into out[0..k) without allocating;
+    // returns how many were written
+    int top_moves(const Board& board, int k, ScoredMove* out) const;
+    
+    // All forcing moves for both colours in one pass
+    ThreatSummary classify_threats(const Board& board) const;
+    
+    // Quick check for immediate wins/threats (views of classify_threats)
     Move find_winning_move(const Board& board) const;      // Immediate 5-in-a-row
     Move find_open_four_move(const Board& board) const;    // Creates open four (unstoppable)
     Move find_blocking_move(const Board& board) const;     // Block opponent's 4-in-a-row
     Move find_open_three_block(const Board& board) const;  // Block opponent's open three
     
+    // Pattern class of a window code (Board::window_code) for player
+    static LineClass line_class(int code, int8_t player) {
+        uint8_t entry = pattern_table_[code];
+        return static_cast<LineClass>(player == BLACK ? (entry & 0xF) : (entry >> 4));
+    }
+    
+    // Cells completing five for player if it plays the window's centre, as a
+    // mask over the 8 window cells; non-zero means the move makes a four
+    // (including broken fours, which line_class does not always report)
+    static uint8_t four_gains(int code, int8_t player) {
+        uint16_t entry = gains_table_[code];
+        return static_cast<uint8_t>(player == BLACK ? (entry & 0xFF) : (entry >> 8));
+    }
+    
+    // Board cell of window cell k (see four_gains) around idx along dir
+    static int window_cell(int idx, int dir, int k) {
+        int step = k < PATTERN_REACH ? k - PATTERN_REACH : k - PATTERN_REACH + 1;
+        return to_index(to_x(idx) + DIRECTIONS[dir].first * step,
+                        to_y(idx) + DIRECTIONS[dir].second * step);
+    }
+    
+    // Most cells five_cells can report for one move
+    static constexpr int MAX_FIVE_CELLS = 4 * 2 * PATTERN_REACH;
+    
+    // Cells where player completes five once it has a stone on idx (idx
+    // empty, or holding player's stone); returns how many were written
+    static int five_cells(const Board& board, int idx, int8_t player, int* out);
+    
+    // Stones of player among the 8 window cells of a code
+    static int count_stones(int code, int8_t player);
+    
+    // After player has played idx: is there an empty cell on idx's lines
+    // where player would then have two fives (an open or double four)?
+    // Such a cell gets a five from a window holding idx, so only lines with
+    // two more of player's stones are searched. Double-five cells the
+    // player had before idx are not looked for.
+    static bool new_double_five(const Board& board, int idx, int8_t player);
+    
+    // Classes of the four lines through idx, as bit masks per colour
+    static void line_classes(const Board& board, int idx, uint8_t& black, uint8_t& white);
+    
 private:
     // Pattern evaluation
-    int evaluate_line(const Board& board, int x, int y, int dx, int dy, int8_t player) const;
-    int count_consecutive(const Board& board, int x, int y, int dx, int dy, int8_t player) const;
-    int count_space(const Board& board, int x, int y, int dx, int dy) const;
+    static int pattern_score(int code, int8_t player);
     
-    // Clustering bonus
-    int cluster_bonus(const Board& board, const Move& move) const;
+    // Pattern class per window code: black in the low nibble, white in the
+    // high nibble, so one lookup serves offence and defence
+    static const std::array<uint8_t, PATTERN_CODES> pattern_table_;
     
-    // Precomputed pattern scores (indexed by pattern hash)
-    std::array<int, 6561> pattern_table_; // 3^8 patterns
+    // Five-completing cells per window code: black low byte, white high byte
+    static const std::array<uint16_t, PATTERN_CODES> gains_table_;
     
-    void init_pattern_table();
+    // Clustering bonus
+    int cluster_bonus(const Board& board, const Move& move) const;
 };
 
 } // namespace gomoku
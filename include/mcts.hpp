@@ -2,54 +2,222 @@
 
 #include "board.hpp"
 #include "heuristic.hpp"
+#include "score_cache.hpp"
+#include "vcf.hpp"
+#include "vct.hpp"
+#include "arena.hpp"
+#include "node_table.hpp"
 #include <vector>
-#include <memory>
 #include <random>
 #include <chrono>
+#include <atomic>
+#include <memory>
+#include <mutex>
 
 namespace gomoku {
 
+// How multiple threads share the work of one search
+enum class ParallelMode {
+    TREE,   // All threads grow one shared tree (virtual loss)
+    ROOT    // Each thread grows its own tree; root statistics are merged
+};
+
+// How select scores a node's children
+enum class SelectionRule {
+    UCT,   // UCB1; every open child is visited once before any is revisited
+    PUCT   // AlphaZero-style: value plus a prior-weighted exploration term
+};
+
+// Weight beta of the AMAF value against a child's own value in RAVE
+enum class RaveSchedule {
+    EQUIVALENCE,  // beta = sqrt(k / (3n + k)), k = rave_equivalence
+    MIN_MSE       // beta = n' / (n + n' + 4 b^2 n n'), b = rave_bias (n' = AMAF visits)
+};
+
+// How a search chose its move
+enum class SearchAnswer {
+    SEARCH,     // Tree search
+    ONLY_MOVE,  // The root had a single legal move
+    FORCED,     // Win, five block or open four, answered without a tree
+    VCF,        // Root VCF proof, answered without a tree
+    VCT         // Root VCT proof, answered without a tree
+};
+
 // MCTS configuration
 struct MCTSConfig {
     double exploration_constant = 1.2;  // c in UCT formula
+    SelectionRule selection = SelectionRule::UCT;
+    double puct_constant = 1.0;         // c in PUCT formula
+    double prior_temperature = 3000.0;  // Softmax temperature over heuristic scores, for PUCT priors
     int max_iterations = 10000;
     int max_time_ms = 1000;
     uint64_t seed = 0;  // 0 = use time-based seed
     bool use_heuristic_rollouts = true;
     bool use_random_rollouts = true;
+    bool reuse_tree = true;  // Keep the subtree of the actual position between searches
+    int num_threads = 1;     // Threads searching
+    ParallelMode parallel_mode = ParallelMode::TREE;
+    int virtual_loss = 1;    // Losses charged to a node while a thread is below it
+    bool use_transpositions = true;  // Share one node between transposed move orders
+    int vcf_root_nodes = 10000;  // VCF budget before searching; a proof plays its first move (0 = off)
+    int vcf_leaf_nodes = 0;      // VCF budget at new leaves; a proof replaces the rollout (0 = off)
+    int vct_root_nodes = 20000;  // VCT budget after the VCF check (0 = off)
+    int vct_root_ms = 50;        // VCT time limit, at most a quarter of the move's time
+    int vct_leaf_nodes = 0;      // VCT budget at new leaves (0 = off)
+    bool use_rave = true;        // Blend all-moves-as-first values into selection
+    RaveSchedule rave_schedule = RaveSchedule::MIN_MSE;
+    double rave_equivalence = 1000.0;  // Visits at which both values weigh about equally
+    double rave_bias = 0.1;            // Assumed AMAF bias for MIN_MSE
+    int max_children = 40;             // Candidate moves per node, best heuristic score first (0 = all)
+    double widening_constant = 2.0;    // Progressive widening (UCT): ceil(c * n^e) children open
+    double widening_exponent = 0.4;    // after n visits (c = 0: all at once)
 };
 
-// MCTS tree node
+// Game-theoretic value of a node once known (MCTS-Solver), from the
+// perspective of the player who moved into it, like terminal_value
+enum ProofState : int8_t {
+    UNPROVEN = 0,
+    PROVEN_WIN,   // The player who moved here wins with best play
+    PROVEN_LOSS,  // ... loses
+    PROVEN_DRAW
+};
+
+using NodeIndex = uint32_t;
+constexpr NodeIndex NO_NODE = Arena<int>::NONE;
+
+// Edge from a node to one of its children. A node's edges live in one
+// contiguous range of the edge arena, in heuristic score order and expanded
+// in that order; edges whose child is NO_NODE are the moves not yet
+// expanded. With transpositions enabled several edges may lead to the same
+// child, so the search graph is a DAG.
+//
+// The AMAF (all-moves-as-first) statistics count playouts through the parent
+// in which the parent's player to move played this move at any later point,
+// valued from that player's perspective.
+struct MCTSEdge {
+    Move move;          // Move leading to the child
+    NodeIndex child;    // Child node index, NO_NODE if untried
+    float prior;        // Softmax of the heuristic score over the node's candidates
+    std::atomic<int> amaf_visits;
+    std::atomic<float> amaf_total;
+    
+    MCTSEdge() = default;
+    MCTSEdge(const MCTSEdge& other) { *this = other; }
+    MCTSEdge& operator=(const MCTSEdge& other);
+    
+    void init(const Move& m, float p) {
+        move = m;
+        child = NO_NODE;
+        prior = p;
+        amaf_visits.store(0, std::memory_order_relaxed);
+        amaf_total.store(0.0f, std::memory_order_relaxed);
+    }
+    
+    double amaf_value() const {
+        int n = amaf_visits.load(std::memory_order_relaxed);
+        return n > 0 ? amaf_total.load(std::memory_order_relaxed) / n : 0.0;
+    }
+};
+
+// MCTS tree node (storage owned by the node arena).
+// The statistics are atomic so several threads can search one tree; the
+// structural fields are written once before the node is published, except
+// the edge range, which MCTS::widen may move to a larger one. Readers load
+// num_expanded or num_edges before first_edge, so they never index past
+// the range they see.
 struct MCTSNode {
-    Move move;                                    // Move that led to this node
-    MCTSNode* parent;                            // Parent node
-    std::vector<std::unique_ptr<MCTSNode>> children;  // Child nodes
-    std::vector<Move> untried_moves;             // Moves not yet expanded
+    uint64_t hash;          // Zobrist key of the position
+    std::atomic<uint32_t> first_edge;  // Start of this node's edge range
+    std::atomic<uint16_t> num_edges;   // Number of candidate moves at this node
+    std::atomic<bool> all_moves;       // The candidates are every legal move (or the forced one)
+    std::atomic<uint16_t> num_expanded;  // Edges [0, num_expanded) have children
     
-    int visit_count;    // N
-    double total_value; // W
+    std::atomic<int> visit_count;    // N
+    std::atomic<double> total_value; // W
+    std::atomic<int> virtual_loss;   // Threads currently below this node
+    std::atomic<bool> expanding;     // Expansion lock
+    std::atomic<int8_t> proof;       // ProofState, set once and never cleared
     int8_t player_to_move; // Player who will make the next move
     
     bool is_terminal_node;   // True if this node represents a terminal game state
     double terminal_value;   // Fixed value for terminal nodes (1.0 = win, -1.0 = loss, 0.0 = draw)
     
-    MCTSNode(const Move& m = Move(), MCTSNode* p = nullptr, int8_t player = BLACK)
-        : move(m), parent(p), visit_count(0), total_value(0.0), player_to_move(player),
-          is_terminal_node(false), terminal_value(0.0) {}
+    MCTSNode() = default;
+    MCTSNode& operator=(const MCTSNode& other);
+    
+    void init(uint64_t key, int8_t player) {
+        hash = key;
+        first_edge.store(0, std::memory_order_relaxed);
+        num_edges.store(0, std::memory_order_relaxed);
+        all_moves.store(true, std::memory_order_relaxed);
+        num_expanded.store(0, std::memory_order_relaxed);
+        visit_count.store(0, std::memory_order_relaxed);
+        total_value.store(0.0, std::memory_order_relaxed);
+        virtual_loss.store(0, std::memory_order_relaxed);
+        expanding.store(false, std::memory_order_relaxed);
+        proof.store(UNPROVEN, std::memory_order_relaxed);
+        player_to_move = player;
+        is_terminal_node = false;
+        terminal_value = 0.0;
+    }
     
     double q_value() const {
-        return visit_count > 0 ? total_value / visit_count : 0.0;
+        int n = visit_count.load(std::memory_order_relaxed);
+        return n > 0 ? total_value.load(std::memory_order_relaxed) / n : 0.0;
+    }
+    
+    int expanded_count() const {
+        return num_expanded.load(std::memory_order_acquire);
+    }
+    
+    int edge_count() const {
+        return num_edges.load(std::memory_order_acquire);
     }
     
     bool is_fully_expanded() const {
-        return untried_moves.empty();
+        return expanded_count() == edge_count();
+    }
+    
+    // Untried edges, or legal moves past a max_children cut that MCTS::widen
+    // may add once every candidate is lost
+    bool may_expand() const {
+        return !is_fully_expanded() || !all_moves.load(std::memory_order_acquire);
     }
     
     bool is_leaf() const {
-        return children.empty();
+        return expanded_count() == 0;
+    }
+    
+    ProofState proof_state() const {
+        return static_cast<ProofState>(proof.load(std::memory_order_acquire));
     }
 };
 
+// Per-thread search state
+struct SearchContext {
+    std::mt19937_64 rng;
+    Board board;                  // Played forward and unmade back to the root every iteration
+    std::vector<NodeIndex> path;  // Nodes visited this iteration, root first
+    ScoreCache scores;            // Move scores for board, synced before use
+    VCFSolver vcf;                // Leaf VCF checks
+    VCTSolver vct;                // Leaf VCT checks
+    
+    // Moves and result (for the leaf's player to move) of this iteration's
+    // rollouts, kept for the AMAF update when RAVE is on
+    struct Playout {
+        std::vector<Move> moves;
+        double value;
+    };
+    std::array<Playout, 2> playouts;
+    int num_playouts = 0;
+};
+
+// Root child statistics indexed by move cell, merged across trees
+struct RootStats {
+    std::array<int, BOARD_CELLS> visits;
+    std::array<double, BOARD_CELLS> total_value;
+};
+
 class MCTS {
 public:
     explicit MCTS(const MCTSConfig& config = MCTSConfig());
@@ -57,10 +225,33 @@ public:
     // Search for best move
     Move search(const Board& board);
     Move search(const Board& board, int time_limit_ms);
+    // Search for time_limit_ms, then keep extending by half of it, up to
+    // max_time_ms in total, while the most visited root move changed in the
+    // last half (e.g. a TimeBudget from TimeManager)
+    Move search(const Board& board, int time_limit_ms, int max_time_ms);
     
-    // Get statistics
-    int get_iterations() const { return iterations_; }
+    // Get statistics (iterations are summed over root-parallel trees). The
+    // tree getters report nothing after a move answered without searching.
+    int get_iterations() const { return iterations_.load(); }
     int get_root_visits() const;
+    int get_root_children() const;  // Children expanded at the root
+    size_t get_node_count() const;
+    size_t get_edge_count() const;
+    int get_transpositions() const { return transpositions_.load(); }
+    int get_extensions() const { return extensions_; }  // Slices added by the last search for an unstable move
+    int get_short_circuits() const { return short_circuits_; }  // Searches answered without a tree
+    int get_vcf_wins() const { return vcf_wins_; }  // Of those, answered by a root VCF proof
+    int get_vct_wins() const { return vct_wins_; }  // Of those, answered by a root VCT proof
+    SearchAnswer get_answer() const { return answer_; }  // How the last search chose its move
+    // Proof state of the last search's root, from the perspective of the
+    // player who moved into it (PROVEN_LOSS: the side to move wins)
+    ProofState get_root_proof() const;
+    // Most visited root move of the last search, before the threat
+    // priorities of the final move choice are applied
+    Move get_most_visited_move() const;
+    
+    // Forget the search tree (e.g. on a new game)
+    void clear_tree();
     
     // Access config
     MCTSConfig& config() { return config_; }
@@ -69,27 +260,117 @@ public:
 private:
     MCTSConfig config_;
     Heuristic heuristic_;
+    VCFSolver vcf_;  // Root VCF check
+    VCTSolver vct_;  // Root VCT check
     std::mt19937_64 rng_;
-    int iterations_;
+    std::atomic<int> iterations_;
+    int iteration_limit_;
+    
+    // Tree storage; the spare pair is the target when compacting a reused subtree
+    Arena<MCTSNode> nodes_;
+    Arena<MCTSEdge> edges_;
+    Arena<MCTSNode> spare_nodes_;
+    Arena<MCTSEdge> spare_edges_;
+    std::mutex tree_mutex_;  // Serializes node creation between threads
+    
+    // Position key -> node, for merging transpositions
+    NodeTable table_;
+    NodeTable spare_table_;
+    std::atomic<int> transpositions_;
+    int extensions_;
+    int short_circuits_;
+    int vcf_wins_;
+    int vct_wins_;
+    SearchAnswer answer_;
+    
+    // Root of the last search and the move history it was built for
+    NodeIndex root_;
+    std::vector<Move> root_history_;
+    
+    // The last search built or walked the tree behind the getters
+    bool has_tree() const { return answer_ == SearchAnswer::SEARCH && root_ != NO_NODE; }
+    
+    // Independent searchers used by ParallelMode::ROOT
+    std::vector<std::unique_ptr<MCTS>> root_workers_;
+    
+    // Heuristic rollouts pick uniformly among this many best moves
+    static constexpr int ROLLOUT_TOP = 3;
+    
+    NodeIndex create_node(const Board& board, const ScoredMove* ordered, int num_ordered,
+                          bool forced);
+    NodeIndex advance_root(const Board& board);
+    NodeIndex prepare_root(const Board& board);
+    
+    // Parallel drivers; a search may run several of them back to back on
+    // the same root, adding to the counters reset by search()
+    void run_search(NodeIndex root, const Board& board, int time_limit_ms, int num_threads);
+    void prepare_root_workers(int num_threads);
+    void search_root_parallel(const Board& board, int time_limit_ms, bool first_slice);
+    void add_root_stats(RootStats& stats) const;
+    MCTSEdge* edges_of(const MCTSNode* node) {
+        return edges_.ptr(node->first_edge.load(std::memory_order_acquire));
+    }
+    
+    // Search loop run by every thread
+    void search_worker(NodeIndex root, const Board& board, SearchContext& ctx,
+                       std::chrono::high_resolution_clock::time_point start_time,
+                       int time_limit_ms);
     
     // Core MCTS phases
-    MCTSNode* select(MCTSNode* node, Board& board);
-    MCTSNode* expand(MCTSNode* node, Board& board);
-    double rollout(Board& board);
-    void backpropagate(MCTSNode* node, double value, int8_t root_player);
+    NodeIndex select(NodeIndex node, Board& board, SearchContext& ctx);
+    NodeIndex expand(NodeIndex node, Board& board, SearchContext& ctx);
+    
+    // A node cut off at max_children whose children are all lost gets
+    // every legal move as a candidate, so the solver can still prove it;
+    // caller holds the node's expansion lock. True if it was widened.
+    bool widen(MCTSNode* node, Board& board, SearchContext& ctx);
+    double rollout(Board& board, SearchContext& ctx);
+    void backpropagate(const std::vector<NodeIndex>& path, double value, int8_t root_player);
+    
+    // RAVE: credit the moves each path node's player to move made below it,
+    // in the tree and in the rollouts, to that node's expanded edges.
+    // leaf_value scores a leaf without rollouts for its player to move.
+    void update_amaf(SearchContext& ctx, int root_moves, double leaf_value);
+    void record_playout(SearchContext& ctx, const Board& board, int start_moves, double value) const;
+    
+    // MCTS-Solver: prove node from its children (any child won for the
+    // player to move, or all of them lost / drawn); true if it became proven
+    bool update_proof(MCTSNode* node);
+    
+    // Progressive widening: children open to selection at the node's visit
+    // count; select stops at a node with fewer expanded to add the next one
+    int children_allowed(const MCTSNode* node) const;
+    
+    // Child value for the parent's player to move after n visits (pending
+    // ones included), blended with the edge's AMAF value when RAVE is on
+    double child_value(const MCTSNode* node, const MCTSEdge& edge, int n, int pending) const;
     
     // UCT calculation
-    double uct_value(const MCTSNode* node, int parent_visits) const;
+    double uct_value(const MCTSNode* node, const MCTSEdge& edge, int parent_visits) const;
+    
+    // PUCT calculation; node is null for an edge not expanded yet, which
+    // is valued at fpu (the parent's own value)
+    double puct_value(const MCTSNode* node, const MCTSEdge& edge, double fpu,
+                      int parent_visits) const;
     
     // Rollout policies
-    double heuristic_rollout(Board& board);
-    double random_rollout(Board& board);
+    double heuristic_rollout(Board& board, SearchContext& ctx);
+    double random_rollout(Board& board, SearchContext& ctx);
     
     // Move selection
-    Move select_best_move(MCTSNode* root, const Board& board) const;
+    Move select_best_move(const MCTSNode* root, const Board& board) const;
+    Move most_visited_move(const MCTSNode* root) const;
     
     // Utility
-    void init_untried_moves(MCTSNode* node, const Board& board);
+    void init_untried_moves(MCTSNode* node, const Board& board,
+                            const ScoredMove* ordered, int num_ordered, bool forced);
+    void init_edges(MCTSEdge* edges, const ScoredMove* ordered, int num_ordered) const;
+    
+    // Candidates of a new node, scored once: its forced move (the only
+    // edge), or its max_children best moves by heuristic score
+    template <typename Scorer>
+    int order_moves(const Scorer& scorer, const Board& board, ScoredMove* ordered,
+                    bool& forced) const;
 };
 
 } // namespace gomoku
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace gomoku {
+
+// Open-addressing map from position key to node index, used to merge
+// transpositions in the search tree. Entries are stamped with a generation,
+// so clear() is O(1) like the arenas it indexes. Not thread-safe.
+class NodeTable {
+public:
+    static constexpr uint32_t NOT_FOUND = ~uint32_t(0);
+
+    NodeTable() : generation_(1), count_(0) { slots_.resize(1 << 12); }
+
+    uint32_t find(uint64_t key) const {
+        size_t mask = slots_.size() - 1;
+        for (size_t i = key & mask;; i = (i + 1) & mask) {
+            const Slot& slot = slots_[i];
+            if (slot.generation != generation_) return NOT_FOUND;
+            if (slot.key == key) return slot.value;
+        }
+    }
+
+    void insert(uint64_t key, uint32_t value) {
+        if (2 * (count_ + 1) > slots_.size()) grow();
+        place(key, value);
+        ++count_;
+    }
+
+    void clear() {
+        if (++generation_ == 0) {
+            // Stamp wrapped around: wipe for real once every 2^32 clears
+            for (auto& slot : slots_) slot.generation = 0;
+            generation_ = 1;
+        }
+        count_ = 0;
+    }
+
+    void swap(NodeTable& other) {
+        slots_.swap(other.slots_);
+        std::swap(generation_, other.generation_);
+        std::swap(count_, other.count_);
+    }
+
+    size_t size() const { return count_; }
+
+private:
+    struct Slot {
+        uint64_t key = 0;
+        uint32_t value = 0;
+        uint32_t generation = 0;
+    };
+
+    std::vector<Slot> slots_;
+    uint32_t generation_;
+    size_t count_;
+
+    void place(uint64_t key, uint32_t value) {
+        size_t mask = slots_.size() - 1;
+        size_t i = key & mask;
+        while (slots_[i].generation == generation_) {
+            i = (i + 1) & mask;
+        }
+        slots_[i] = {key, value, generation_};
+    }
+
+    void grow() {
+        std::vector<Slot> old(slots_.size() * 2);
+        old.swap(slots_);
+        uint32_t old_generation = generation_;
+        generation_ = 1;
+        for (const auto& slot : old) {
+            if (slot.generation == old_generation) place(slot.key, slot.value);
+        }
+    }
+};
+
+} // namespace gomoku
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "heuristic.hpp"
+#include <vector>
+
+namespace gomoku {
+
+// Heuristic::score_move results for every cell, patched as stones come and
+// go instead of recomputed. A stone only changes the line scores of cells
+// whose pattern windows contain it (within PATTERN_REACH along each
+// direction, and only the window along that direction) and the
+// cluster/space bonus of cells within radius 2, so a move touches a few
+// dozen cells and one window of each.
+//
+// The cache follows one Board. make_move/unmake_to play through the cache;
+// sync() catches up with moves made on the board directly by undoing and
+// replaying the difference between the two histories.
+class ScoreCache {
+public:
+    ScoreCache();
+    
+    // Bring the cache in line with board's current position
+    void sync(const Board& board);
+    
+    // Play / take back moves on a synced board, patching the cache
+    void make_move(Board& board, const Move& move);
+    void unmake_to(Board& board, int move_count);
+    
+    // Same result as Heuristic::score_move for the side to move, on an
+    // empty cell
+    ScoredMove score_move(const Board& board, const Move& move) const;
+    
+    // Same result as Heuristic::top_moves; optionally also fills threats
+    // (as classify_threats) in the same pass
+    int top_moves(const Board& board, int k, ScoredMove* out,
+                  ThreatSummary* threats = nullptr) const;
+    
+    // Same result as Heuristic::classify_threats
+    ThreatSummary classify_threats(const Board& board) const;
+    
+private:
+    struct CellScores {
+        int line[2];        // Sum of line pattern scores, per colour
+        int defence[2];     // line * 1.1, the weight of the opponent's lines
+        int cluster[2];     // cluster_bonus() with that colour to move
+        uint8_t classes[2]; // Line classes present, as 1 << LineClass
+        uint8_t dir_class[2][4];  // LineClass per direction, per colour
+        int64_t rank[2];    // score_move in ScoredMove order, per colour to move
+    };
+    
+    std::array<CellScores, BOARD_CELLS> cells_;
+    std::vector<Move> history_;  // Moves reflected in cells_; colours alternate from BLACK
+    
+    static int slot(int8_t player) { return player == BLACK ? 0 : 1; }
+    
+    // Orders like ScoredMove::operator>: winning, then blocking, then score
+    static int64_t rank(bool winning, bool blocking, int score) {
+        return (int64_t(winning) << 34) | (int64_t(blocking) << 33) |
+               (int64_t(score) + (int64_t(1) << 32));
+    }
+    static void rerank(CellScores& cell);
+    
+    void rescore_line(const Board& board, int idx, int dir);
+    void rescore_lines_around(const Board& board, const Move& move);
+    void add_cluster(const Move& move, int8_t player, int sign);
+};
+
+} // namespace gomoku
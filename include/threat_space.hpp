@@ -0,0 +1,20 @@
+#pragma once
+
+#include "board.hpp"
+#include <cstdint>
+
+namespace gomoku {
+
+// Shared by the threat-space solvers (VCTSolver, DFPNSolver)
+
+// The solvers read the clock once per this many nodes; a node costs a few
+// microseconds at most
+constexpr uint64_t TIME_CHECK_INTERVAL = 256;
+
+// Replies for the side to move against the opponent's double-five cells:
+// take such a cell or one of its five cells, or play a four, which must be
+// answered first. Returns how many double-five cells the opponent has, or
+// -1 if the side to move has a double four, which wins the race outright.
+int threat_replies(const Board& board, BitBoard& replies);
+
+} // namespace gomoku
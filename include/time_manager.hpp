@@ -0,0 +1,42 @@
+#pragma once
+
+namespace gomoku {
+
+// Clock state of the side to move, as given by "go wtime/btime/winc/binc/movestogo"
+struct TimeControl {
+    int time_ms = 0;       // Time left on the clock
+    int increment_ms = 0;  // Added after each move
+    int moves_to_go = 0;   // Moves until the next time control (0 = rest of the game)
+};
+
+// Time for one move: the search normally stops at target_ms and may run on
+// to max_ms while its best move is unstable
+struct TimeBudget {
+    int target_ms = 0;
+    int max_ms = 0;
+};
+
+// Splits the clock over the moves expected to remain: movestogo if given,
+// else an estimate from the number of stones on the board. The share is
+// weighted by game phase (little in the opening, most in the middlegame,
+// where games are decided), the increment is spent as it comes, and a
+// fixed overhead per move is kept back for communication.
+class TimeManager {
+public:
+    explicit TimeManager(int overhead_ms = 20);
+
+    TimeBudget allocate(const TimeControl& control, int move_count) const;
+
+    int overhead_ms() const { return overhead_ms_; }
+
+private:
+    int overhead_ms_;
+
+    // Own moves the side to move is expected to still play
+    static int expected_moves_left(int move_count);
+
+    // Weight of a move's share of the clock at this point of the game
+    static double phase_factor(int move_count);
+};
+
+} // namespace gomoku
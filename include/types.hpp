@@ -2,7 +2,6 @@
 
 #include <cstdint>
 #include <array>
-#include <bitset>
 
 namespace gomoku {
 
@@ -26,6 +25,16 @@ constexpr std::array<std::pair<int, int>, 4> DIRECTIONS = {{
     {1, -1}   // Anti-diagonal
 }};
 
+// Pattern windows: the PATTERN_REACH cells on each side of a cell along one
+// direction, two bits per cell. Cells -4..-1 fill the low byte and +1..+4
+// the high byte, so codes index tables of 4^8 entries.
+constexpr int PATTERN_REACH = 4;
+constexpr int PATTERN_CODES = 1 << (4 * PATTERN_REACH);
+constexpr int CELL_EMPTY = 0;
+constexpr int CELL_BLACK = 1;
+constexpr int CELL_WHITE = 2;
+constexpr int CELL_WALL = 3;   // Off the board
+
 // Utility functions
 inline constexpr int to_index(int x, int y) {
     return y * BOARD_SIZE + x;
@@ -62,8 +71,23 @@ struct Move {
     }
 };
 
-// Bitset for 225 cells
-using BitBoard = std::bitset<BOARD_CELLS>;
+// Fixed-capacity move list, filled without heap allocation
+struct MoveList {
+    std::array<Move, BOARD_CELLS> moves;
+    int count = 0;
+    
+    void clear() { count = 0; }
+    void push_back(const Move& m) { moves[count++] = m; }
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+    
+    Move& operator[](int i) { return moves[i]; }
+    const Move& operator[](int i) const { return moves[i]; }
+    Move* begin() { return moves.data(); }
+    Move* end() { return moves.data() + count; }
+    const Move* begin() const { return moves.data(); }
+    const Move* end() const { return moves.data() + count; }
+};
 
 // Game result
 enum class GameResult {
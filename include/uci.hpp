@@ -2,9 +2,12 @@
 
 #include "board.hpp"
 #include "mcts.hpp"
+#include "dfpn.hpp"
+#include "time_manager.hpp"
 #include <string>
 #include <sstream>
 #include <functional>
+#include <memory>
 
 namespace gomoku {
 
@@ -24,23 +27,31 @@ public:
 private:
     Board board_;
     MCTS mcts_;
+    std::unique_ptr<DFPNSolver> solver_;  // Created by the first solve command
+    TimeManager time_manager_;
     bool running_;
     std::function<void(const std::string&)> output_handler_;
     
     // Command handlers
     std::string cmd_uci();
     std::string cmd_isready();
+    std::string cmd_setoption(std::istringstream& args);
     std::string cmd_position(std::istringstream& args);
     std::string cmd_go(std::istringstream& args);
     std::string cmd_stop();
     std::string cmd_quit();
     std::string cmd_display();
     std::string cmd_perft(std::istringstream& args);
+    std::string cmd_solve(std::istringstream& args);
     
     // Parsing helpers
     Move parse_move(const std::string& move_str) const;
     std::string move_to_string(const Move& move) const;
     
+    // bestmove reply for the last search, after an info line if it was
+    // answered without searching
+    std::string report_move(const Move& move);
+    
     // Output
     void output(const std::string& msg);
 };
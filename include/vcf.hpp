@@ -0,0 +1,49 @@
+#pragma once
+
+#include "board.hpp"
+#include "heuristic.hpp"
+#include "node_table.hpp"
+#include <vector>
+
+namespace gomoku {
+
+// Outcome of one VCFSolver::solve call
+struct VCFResult {
+    bool proven = false;         // Side to move wins by continuous fours
+    std::vector<Move> line;      // Attacker moves and forced replies, alternating;
+                                 // ends with a five or a move making two fives
+    uint64_t nodes = 0;          // Attacker positions searched
+    bool budget_exhausted = false;  // Gave up without refuting every line
+};
+
+// Victory by continuous fours: searches only attacker moves that make a four
+// (the defender's reply is then forced) until the attacker completes five or
+// threatens two fives at once. The defender's forced replies may make fours
+// of their own, which the attacker must block, and only with another four.
+//
+// Fours are found exactly with Heuristic::four_gains, broken fours
+// included. Positions refuted once are remembered by Zobrist key for the
+// rest of the call. Not thread-safe; use one solver per thread.
+class VCFSolver {
+public:
+    explicit VCFSolver(uint64_t node_budget = 10000);
+
+    // Solve for board's side to move; board is restored before returning
+    VCFResult solve(Board& board);
+
+    void set_node_budget(uint64_t budget) { budget_ = budget; }
+    uint64_t node_budget() const { return budget_; }
+
+private:
+    Heuristic heuristic_;
+    uint64_t budget_;
+    uint64_t nodes_;
+    bool exhausted_;
+    NodeTable refuted_;       // Attacker positions without a VCF
+    std::vector<Move> line_;  // Current line from the root
+
+    // Attacker to move; must is the defender's five to block, or -1
+    bool attack(Board& board, int must);
+};
+
+} // namespace gomoku
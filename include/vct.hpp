@@ -0,0 +1,70 @@
+#pragma once
+
+#include "board.hpp"
+#include "heuristic.hpp"
+#include "node_table.hpp"
+#include <chrono>
+#include <vector>
+
+namespace gomoku {
+
+// Outcome of one VCTSolver::solve call
+struct VCTResult {
+    bool proven = false;         // Side to move wins by continuous threats
+    std::vector<Move> line;      // One line of the proof: attacker threats and
+                                 // defender replies, ending with the winning threat
+    uint64_t nodes = 0;          // Attacker and defender positions searched
+    bool limit_reached = false;  // Node or time limit cut the search
+};
+
+// Victory by continuous threats: like VCFSolver, but the attacker may also
+// play threes, i.e. moves after which it has a cell making two fives (an
+// open four or a double four). The defender then is not forced to a single
+// cell, but its only useful replies are few: those double-five cells, their
+// five cells, and its own fours; all of them must fail for a proof. A
+// defender double four refutes a three outright.
+//
+// Dependency-based pruning: below the root, a three must share a line
+// (within PATTERN_REACH) with the attacker's previous threat, so only threats
+// building on the last gain are tried. Fours are always tried. This can miss
+// proofs but never invents one.
+//
+// Each call stops at its node budget, time limit or depth (attacker moves)
+// and reports an unproven result. Not thread-safe; use one solver per thread.
+class VCTSolver {
+public:
+    explicit VCTSolver(uint64_t node_budget = 20000, int time_limit_ms = 0, int max_depth = 10);
+
+    // Solve for board's side to move; board is restored before returning
+    VCTResult solve(Board& board);
+
+    void set_node_budget(uint64_t budget) { budget_ = budget; }
+    void set_time_limit(int ms) { time_limit_ms_ = ms; }  // 0 = none
+    void set_max_depth(int depth) { max_depth_ = depth; }
+
+private:
+    Heuristic heuristic_;
+    uint64_t budget_;
+    int time_limit_ms_;
+    int max_depth_;
+    uint64_t nodes_;
+    bool cut_;
+    std::chrono::steady_clock::time_point deadline_;
+    NodeTable refuted_;       // Failed attacker / held defender positions
+    std::vector<Move> line_;  // Current line from the root
+
+    bool out_of_budget();
+
+    // Attacker to move with depth threats left; must is the defender's five
+    // to block (or -1), last the attacker's previous threat (or -1)
+    bool attack(Board& board, int must, int last, int depth);
+
+    // Defender to move against a three
+    bool defend(Board& board, int last, int depth);
+
+    // After the attacker played idx: does it have a cell making two fives?
+    // Only idx's lines are searched unless full is set.
+    bool has_double_five(const Board& board, int idx, bool full) const;
+};
+
+} // namespace gomoku
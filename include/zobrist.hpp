@@ -0,0 +1,42 @@
+#pragma once
+
+#include "types.hpp"
+
+namespace gomoku {
+
+// Zobrist keys, generated at compile time with SplitMix64
+namespace zobrist {
+
+constexpr uint64_t splitmix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+struct Keys {
+    uint64_t stone[2][BOARD_CELLS]; // [0] = BLACK, [1] = WHITE
+    uint64_t white_to_move;
+};
+
+constexpr Keys make_keys() {
+    Keys keys{};
+    uint64_t state = 0x60E0C0DEULL;
+    for (int color = 0; color < 2; ++color) {
+        for (int idx = 0; idx < BOARD_CELLS; ++idx) {
+            keys.stone[color][idx] = splitmix64(state);
+        }
+    }
+    keys.white_to_move = splitmix64(state);
+    return keys;
+}
+
+inline constexpr Keys KEYS = make_keys();
+
+inline constexpr uint64_t stone_key(int8_t player, int idx) {
+    return KEYS.stone[player == BLACK ? 0 : 1][idx];
+}
+
+} // namespace zobrist
+
+} // namespace gomoku
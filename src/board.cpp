@@ -1,10 +1,85 @@
 #include "board.hpp"
+#include "zobrist.hpp"
 #include <sstream>
 #include <algorithm>
 
 namespace gomoku {
 
+namespace {
+
+// Window codes of the empty board: only the off-board cells are set
+constexpr std::array<uint16_t, BOARD_CELLS * 4> make_empty_windows() {
+    std::array<uint16_t, BOARD_CELLS * 4> windows{};
+    for (int idx = 0; idx < BOARD_CELLS; ++idx) {
+        for (int dir = 0; dir < 4; ++dir) {
+            int dx = DIRECTIONS[dir].first;
+            int dy = DIRECTIONS[dir].second;
+            int code = 0;
+            for (int i = 1; i <= PATTERN_REACH; ++i) {
+                if (!in_bounds(to_x(idx) - dx * i, to_y(idx) - dy * i)) {
+                    code |= CELL_WALL << (2 * (PATTERN_REACH - i));
+                }
+                if (!in_bounds(to_x(idx) + dx * i, to_y(idx) + dy * i)) {
+                    code |= CELL_WALL << (2 * (PATTERN_REACH + i - 1));
+                }
+            }
+            windows[idx * 4 + dir] = static_cast<uint16_t>(code);
+        }
+    }
+    return windows;
+}
+
+// For each cell, the window codes that contain it: a stone there sits at
+// distance i in the windows of the on-board cells i steps away on either
+// side, in every direction (at most 4 * 2 * PATTERN_REACH of them)
+struct WindowSlot {
+    uint16_t slot;   // idx * 4 + dir of the affected window
+    uint8_t shift;   // Bit offset of this cell inside it
+};
+
+struct WindowUpdates {
+    std::array<WindowSlot, 8 * PATTERN_REACH> slots{};
+    int count = 0;
+};
+
+constexpr std::array<WindowUpdates, BOARD_CELLS> make_window_updates() {
+    std::array<WindowUpdates, BOARD_CELLS> updates{};
+    for (int idx = 0; idx < BOARD_CELLS; ++idx) {
+        WindowUpdates& u = updates[idx];
+        for (int dir = 0; dir < 4; ++dir) {
+            int dx = DIRECTIONS[dir].first;
+            int dy = DIRECTIONS[dir].second;
+            for (int i = 1; i <= PATTERN_REACH; ++i) {
+                int nx = to_x(idx) + dx * i;
+                int ny = to_y(idx) + dy * i;
+                if (in_bounds(nx, ny)) {
+                    u.slots[u.count++] = {static_cast<uint16_t>(to_index(nx, ny) * 4 + dir),
+                                          static_cast<uint8_t>(2 * (PATTERN_REACH - i))};
+                }
+                nx = to_x(idx) - dx * i;
+                ny = to_y(idx) - dy * i;
+                if (in_bounds(nx, ny)) {
+                    u.slots[u.count++] = {static_cast<uint16_t>(to_index(nx, ny) * 4 + dir),
+                                          static_cast<uint8_t>(2 * (PATTERN_REACH + i - 1))};
+                }
+            }
+        }
+    }
+    return updates;
+}
+
+constexpr auto EMPTY_WINDOWS = make_empty_windows();
+constexpr auto WINDOW_UPDATES = make_window_updates();
+
+constexpr int cell_state(int8_t stone) {
+    return stone == BLACK ? CELL_BLACK : stone == WHITE ? CELL_WHITE : CELL_EMPTY;
+}
+
+} // namespace
+
 Board::Board() {
+    history_.reserve(BOARD_CELLS);
+    legal_undo_.reserve(BOARD_CELLS);
     reset();
 }
 
@@ -14,10 +89,16 @@ void Board::reset() {
     black_mask_.reset();
     white_mask_.reset();
     legal_mask_.reset();
+    for (auto& per_player : line_masks_) {
+        for (auto& per_dir : per_player) per_dir.fill(0);
+    }
+    windows_ = EMPTY_WINDOWS;
     current_player_ = BLACK;
     is_terminal_ = false;
     result_ = GameResult::ONGOING;
+    hash_ = 0;
     history_.clear();
+    legal_undo_.clear();
 }
 
 void Board::make_move(int x, int y) {
@@ -30,6 +111,9 @@ void Board::make_move(const Move& move) {
     // Place stone
     cells_[idx] = current_player_;
     occupied_mask_.set(idx);
+    hash_ ^= zobrist::stone_key(current_player_, idx);
+    toggle_lines(current_player_, move.x, move.y);
+    toggle_windows(current_player_, move.x, move.y);
     
     if (current_player_ == BLACK) {
         black_mask_.set(idx);
@@ -37,7 +121,8 @@ void Board::make_move(const Move& move) {
         white_mask_.set(idx);
     }
     
-    // Update legal mask
+    // Update legal mask, remembering the old one for unmake
+    legal_undo_.push_back(legal_mask_);
     update_legal_mask(move);
     
     // Remove this square from legal moves
@@ -58,6 +143,7 @@ void Board::make_move(const Move& move) {
     
     // Switch player
     current_player_ = -current_player_;
+    hash_ ^= zobrist::KEYS.white_to_move;
 }
 
 void Board::unmake_move(const Move& move) {
@@ -65,10 +151,14 @@ void Board::unmake_move(const Move& move) {
     
     // Switch player back
     current_player_ = -current_player_;
+    hash_ ^= zobrist::KEYS.white_to_move;
     
     int idx = move.to_index();
     
     // Remove stone
+    hash_ ^= zobrist::stone_key(cells_[idx], idx);
+    toggle_lines(cells_[idx], move.x, move.y);
+    toggle_windows(cells_[idx], move.x, move.y);
     cells_[idx] = EMPTY;
     occupied_mask_.reset(idx);
     black_mask_.reset(idx);
@@ -78,30 +168,15 @@ void Board::unmake_move(const Move& move) {
     is_terminal_ = false;
     result_ = GameResult::ONGOING;
     
-    // Remove from history
+    // Remove from history and restore the legal mask
     history_.pop_back();
-    
-    // Rebuild legal mask (simpler than tracking changes)
-    legal_mask_.reset();
-    if (history_.empty()) {
-        // If board is empty after unmake, no legal moves yet
-        // First move can be anywhere - for simplicity, center area
-        legal_mask_.set(to_index(7, 7));
-    } else {
-        // Rebuild from all existing stones
-        for (const auto& m : history_) {
-            int mx = m.x;
-            int my = m.y;
-            for (int dy = -LEGAL_RADIUS; dy <= LEGAL_RADIUS; ++dy) {
-                for (int dx = -LEGAL_RADIUS; dx <= LEGAL_RADIUS; ++dx) {
-                    int nx = mx + dx;
-                    int ny = my + dy;
-                    if (in_bounds(nx, ny) && !occupied_mask_[to_index(nx, ny)]) {
-                        legal_mask_.set(to_index(nx, ny));
-                    }
-                }
-            }
-        }
+    legal_mask_ = legal_undo_.back();
+    legal_undo_.pop_back();
+}
+
+void Board::unmake_to(int move_count) {
+    while (static_cast<int>(history_.size()) > move_count) {
+        unmake_move(history_.back());
     }
 }
 
@@ -111,26 +186,8 @@ void Board::update_legal_mask(const Move& move) {
         legal_mask_.set(move.to_index());
     }
     
-    // Add all empty cells within Chebyshev radius 2
-    int mx = move.x;
-    int my = move.y;
-    for (int dy = -LEGAL_RADIUS; dy <= LEGAL_RADIUS; ++dy) {
-        for (int dx = -LEGAL_RADIUS; dx <= LEGAL_RADIUS; ++dx) {
-            int nx = mx + dx;
-            int ny = my + dy;
-            if (in_bounds(nx, ny) && !occupied_mask_[to_index(nx, ny)]) {
-                legal_mask_.set(to_index(nx, ny));
-            }
-        }
-    }
-}
-
-int8_t Board::get(int x, int y) const {
-    return cells_[to_index(x, y)];
-}
-
-int8_t Board::get(int idx) const {
-    return cells_[idx];
+    // Add all empty cells within Chebyshev radius 2 (word-wide dilation)
+    legal_mask_ |= BitBoard::single(move.to_index()).dilate(LEGAL_RADIUS) & ~occupied_mask_;
 }
 
 bool Board::is_empty(int x, int y) const {
@@ -155,27 +212,34 @@ bool Board::is_legal(const Move& move) const {
 
 std::vector<Move> Board::get_legal_moves() const {
     std::vector<Move> moves;
-    
-    // First move - just return center
-    if (history_.empty()) {
-        moves.emplace_back(7, 7);
-        return moves;
-    }
-    
-    moves.reserve(legal_mask_.count());
-    for (int idx = 0; idx < BOARD_CELLS; ++idx) {
-        if (legal_mask_[idx]) {
-            moves.emplace_back(to_x(idx), to_y(idx));
-        }
-    }
+    moves.reserve(count_legal_moves());
+    for_each_legal_move([&](const Move& m) { moves.push_back(m); });
     return moves;
 }
 
+void Board::get_legal_moves(MoveList& out) const {
+    out.clear();
+    for_each_legal_move([&](const Move& m) { out.push_back(m); });
+}
+
 int Board::count_legal_moves() const {
     if (history_.empty()) return 1;
     return static_cast<int>(legal_mask_.count());
 }
 
+uint64_t Board::compute_hash() const {
+    uint64_t h = 0;
+    for (int idx = 0; idx < BOARD_CELLS; ++idx) {
+        if (cells_[idx] != EMPTY) {
+            h ^= zobrist::stone_key(cells_[idx], idx);
+        }
+    }
+    if (current_player_ == WHITE) {
+        h ^= zobrist::KEYS.white_to_move;
+    }
+    return h;
+}
+
 int8_t Board::get_winner() const {
     switch (result_) {
         case GameResult::BLACK_WIN: return BLACK;
@@ -184,34 +248,61 @@ int8_t Board::get_winner() const {
     }
 }
 
-bool Board::check_win(const Move& move) const {
+void Board::toggle_lines(int8_t player, int x, int y) {
+    auto& masks = line_masks_[player_slot(player)];
+    for (int dir = 0; dir < 4; ++dir) {
+        masks[dir][line_index(dir, x, y)] ^= uint16_t(1) << line_pos(dir, x, y);
+    }
+}
+
+void Board::toggle_windows(int8_t player, int x, int y) {
+    // An empty cell contributes 0 to a code, so XOR both places and removes
+    int state = cell_state(player);
+    const WindowUpdates& u = WINDOW_UPDATES[to_index(x, y)];
+    for (int k = 0; k < u.count; ++k) {
+        windows_[u.slots[k].slot] ^= static_cast<uint16_t>(state << u.slots[k].shift);
+    }
+}
+
+uint16_t Board::compute_window_code(int idx, int dir) const {
+    int x = to_x(idx);
+    int y = to_y(idx);
+    int dx = DIRECTIONS[dir].first;
+    int dy = DIRECTIONS[dir].second;
+    int code = 0;
+    for (int i = 1; i <= PATTERN_REACH; ++i) {
+        int nx = x - dx * i;
+        int ny = y - dy * i;
+        int neg = in_bounds(nx, ny) ? cell_state(get(nx, ny)) : CELL_WALL;
+        nx = x + dx * i;
+        ny = y + dy * i;
+        int pos = in_bounds(nx, ny) ? cell_state(get(nx, ny)) : CELL_WALL;
+        code |= neg << (2 * (PATTERN_REACH - i));
+        code |= pos << (2 * (PATTERN_REACH + i - 1));
+    }
+    return static_cast<uint16_t>(code);
+}
+
+bool Board::makes_five(const Move& move, int8_t player) const {
     int x = move.x;
     int y = move.y;
-    int8_t player = cells_[move.to_index()];
+    const auto& masks = line_masks_[player_slot(player)];
     
-    for (const auto& [dx, dy] : DIRECTIONS) {
-        int count = 1; // Include the placed stone
-        count += count_direction(x, y, dx, dy, player);
-        count += count_direction(x, y, -dx, -dy, player);
-        
-        if (count >= 5) {
+    for (int dir = 0; dir < 4; ++dir) {
+        int pos = line_pos(dir, x, y);
+        uint32_t line = masks[dir][line_index(dir, x, y)] | (1u << pos);
+        // Bit i survives iff cells i..i+4 are all owned by the player
+        uint32_t fives = line & (line >> 1) & (line >> 2) & (line >> 3) & (line >> 4);
+        // Only runs through this cell count: starts in [pos - 4, pos]
+        if (fives & ((0x1Fu << pos) >> 4)) {
             return true;
         }
     }
     return false;
 }
 
-int Board::count_direction(int x, int y, int dx, int dy, int8_t player) const {
-    int count = 0;
-    int nx = x + dx;
-    int ny = y + dy;
-    
-    while (in_bounds(nx, ny) && cells_[to_index(nx, ny)] == player) {
-        ++count;
-        nx += dx;
-        ny += dy;
-    }
-    return count;
+bool Board::check_win(const Move& move) const {
+    return makes_five(move, cells_[move.to_index()]);
 }
 
 std::string Board::to_string() const {
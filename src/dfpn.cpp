@@ -0,0 +1,291 @@
+#include "dfpn.hpp"
+#include "threat_space.hpp"
+#include <algorithm>
+
+namespace gomoku {
+
+namespace {
+
+uint32_t saturating_add(uint32_t a, uint32_t b, uint32_t limit) {
+    uint64_t sum = uint64_t(a) + b;
+    return sum >= limit ? limit : static_cast<uint32_t>(sum);
+}
+
+} // namespace
+
+DFPNSolver::DFPNSolver(int table_bits)
+    : table_(size_t(1) << std::max(table_bits, 1)), generation_(0), nodes_(0), max_nodes_(0),
+      time_limit_ms_(0), stopped_(false) {}
+
+DFPNResult DFPNSolver::solve(Board& board, uint64_t max_nodes, int time_limit_ms) {
+    DFPNResult result;
+    auto start = std::chrono::steady_clock::now();
+    if (board.is_terminal()) return result;
+
+    if (++generation_ == 0) {
+        // Stamp wrapped around: wipe for real once every 2^32 solves
+        for (auto& entry : table_) entry.generation = 0;
+        generation_ = 1;
+    }
+    nodes_ = 0;
+    max_nodes_ = max_nodes;
+    time_limit_ms_ = time_limit_ms;
+    deadline_ = start + std::chrono::milliseconds(time_limit_ms);
+    stopped_ = false;
+
+    uint32_t pn, dn;
+    mid(board, true, INF, INF, pn, dn);
+    if (pn == 0) {
+        result.outcome = DFPNResult::PROVEN;
+        NodeTable seen;
+        result.proof_size = proof_tree(board, true, seen, &result.line);
+        if (!result.line.empty()) result.best = result.line.front();
+    } else if (dn == 0) {
+        result.outcome = DFPNResult::DISPROVEN;
+    }
+
+    result.nodes = nodes_;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+bool DFPNSolver::out_of_budget() {
+    if (stopped_) return true;
+    if ((max_nodes_ > 0 && nodes_ >= max_nodes_) ||
+        (time_limit_ms_ > 0 && nodes_ % TIME_CHECK_INTERVAL == 0 &&
+         std::chrono::steady_clock::now() >= deadline_)) {
+        stopped_ = true;
+    }
+    return stopped_;
+}
+
+const DFPNSolver::Entry* DFPNSolver::lookup(uint64_t key) const {
+    size_t bucket = key & (table_.size() - 2);
+    for (size_t i = bucket; i < bucket + 2; ++i) {
+        if (is_live(table_[i]) && table_[i].key == key) return &table_[i];
+    }
+    return nullptr;
+}
+
+void DFPNSolver::store(uint64_t key, uint32_t pn, uint32_t dn, uint64_t work) {
+    // Two-way buckets: overwrite the same key, else an empty slot, else the
+    // slot that is unsolved or has less work behind it
+    size_t bucket = key & (table_.size() - 2);
+    Entry* slot = nullptr;
+    for (size_t i = bucket; i < bucket + 2; ++i) {
+        if (is_live(table_[i]) && table_[i].key == key) {
+            slot = &table_[i];
+            break;
+        }
+    }
+    if (!slot) {
+        auto keep_value = [this](const Entry& e) {
+            if (!is_live(e)) return uint64_t(0);
+            bool solved = e.pn == 0 || e.dn == 0;
+            return (uint64_t(solved) << 32) | e.work;
+        };
+        Entry& a = table_[bucket];
+        Entry& b = table_[bucket + 1];
+        slot = keep_value(a) <= keep_value(b) ? &a : &b;
+    }
+    slot->key = key;
+    slot->pn = pn;
+    slot->dn = dn;
+    slot->work = static_cast<uint32_t>(std::min<uint64_t>(std::max<uint64_t>(work, 1), UINT32_MAX));
+    slot->generation = generation_;
+}
+
+int DFPNSolver::generate(Board& board, bool or_node, Move* out, uint32_t* child_pn,
+                         uint32_t* child_dn, uint32_t& pn, uint32_t& dn) {
+    int8_t mover = board.current_player();
+    int8_t other = -mover;
+
+    // Fives come first: the side to move completing one decides the node,
+    // two for the opponent cannot be blocked, one must be
+    Move own_five, other_five;
+    int other_fives = 0;
+    board.for_each_legal_move([&](const Move& m) {
+        if (!own_five.is_valid() && board.makes_five(m, mover)) own_five = m;
+        if (board.makes_five(m, other)) {
+            if (!other_five.is_valid()) other_five = m;
+            ++other_fives;
+        }
+    });
+    if (own_five.is_valid() || other_fives >= 2) {
+        bool attacker_wins = own_five.is_valid() == or_node;
+        pn = attacker_wins ? 0 : INF;
+        dn = attacker_wins ? INF : 0;
+        out[0] = own_five;
+        return -1;
+    }
+    if (other_fives == 1) {
+        out[0] = other_five;
+        child_pn[0] = child_dn[0] = 1;
+        return 1;
+    }
+
+    int cells[Heuristic::MAX_FIVE_CELLS];
+    int n = 0;
+    if (or_node) {
+        // Fours, and moves that may be threes (two more attacker stones on
+        // a line), confirmed below by playing them
+        int candidates[BOARD_CELLS];
+        int num_candidates = 0;
+        board.for_each_legal_move([&](const Move& m) {
+            int idx = m.to_index();
+            int gains = Heuristic::five_cells(board, idx, mover, cells);
+            if (gains > 0) {
+                // Two fives against a defender without one is a win
+                out[n] = m;
+                child_pn[n] = gains >= 2 ? 0 : 1;
+                child_dn[n] = gains >= 2 ? INF : 1;
+                ++n;
+                return;
+            }
+            for (int dir = 0; dir < 4; ++dir) {
+                if (Heuristic::count_stones(board.window_code(idx, dir), mover) >= 2) {
+                    candidates[num_candidates++] = idx;
+                    return;
+                }
+            }
+        });
+        int start = board.move_count();
+        for (int i = 0; i < num_candidates; ++i) {
+            Move m(to_x(candidates[i]), to_y(candidates[i]));
+            board.make_move(m);
+            bool three = Heuristic::new_double_five(board, candidates[i], mover);
+            board.unmake_to(start);
+            if (three) {
+                out[n] = m;
+                child_pn[n] = child_dn[n] = 1;
+                ++n;
+            }
+        }
+    } else {
+        // No replies once the defender has a double four
+        BitBoard replies;
+        if (threat_replies(board, replies) > 0) {
+            replies.for_each([&](int idx) {
+                out[n] = Move(to_x(idx), to_y(idx));
+                child_pn[n] = child_dn[n] = 1;
+                ++n;
+            });
+        }
+    }
+
+    if (n == 0) {
+        // The attacker has run out of threats
+        pn = INF;
+        dn = 0;
+        return -1;
+    }
+    return n;
+}
+
+void DFPNSolver::mid(Board& board, bool or_node, uint32_t th_pn, uint32_t th_dn,
+                     uint32_t& pn, uint32_t& dn) {
+    uint64_t key = board.hash();
+    if (const Entry* entry = lookup(key)) {
+        pn = entry->pn;
+        dn = entry->dn;
+        if (pn >= th_pn || dn >= th_dn) return;
+    } else {
+        pn = dn = 1;
+    }
+    if (out_of_budget()) return;
+    ++nodes_;
+    uint64_t work_start = nodes_;
+
+    Move moves[BOARD_CELLS];
+    uint32_t child_pn[BOARD_CELLS], child_dn[BOARD_CELLS];
+    int n = generate(board, or_node, moves, child_pn, child_dn, pn, dn);
+    if (n < 0) {
+        store(key, pn, dn, 1);
+        return;
+    }
+
+    // Children searched before (by another path or an earlier visit)
+    int start = board.move_count();
+    for (int i = 0; i < n; ++i) {
+        board.make_move(moves[i]);
+        if (const Entry* entry = lookup(board.hash())) {
+            child_pn[i] = entry->pn;
+            child_dn[i] = entry->dn;
+        }
+        board.unmake_to(start);
+    }
+
+    for (;;) {
+        // OR: prove one child, disprove all; AND: the other way round
+        uint32_t sum = 0;
+        uint32_t best_value = INF, second_value = INF;
+        int best = 0;
+        for (int i = 0; i < n; ++i) {
+            uint32_t select = or_node ? child_pn[i] : child_dn[i];
+            sum = saturating_add(sum, or_node ? child_dn[i] : child_pn[i], INF);
+            if (select < best_value) {
+                second_value = best_value;
+                best_value = select;
+                best = i;
+            } else if (select < second_value) {
+                second_value = select;
+            }
+        }
+        pn = or_node ? best_value : sum;
+        dn = or_node ? sum : best_value;
+        if (pn >= th_pn || dn >= th_dn || stopped_) break;
+
+        // Thresholds for the most promising child, with the 1 + epsilon
+        // margin over the runner-up so search does not flip between them
+        uint32_t margin = saturating_add(second_value, second_value / 4 + 1, INF);
+        uint32_t c_pn, c_dn;
+        if (or_node) {
+            c_pn = std::min(th_pn, margin);
+            c_dn = saturating_add(th_dn - dn, child_dn[best], INF);
+        } else {
+            c_dn = std::min(th_dn, margin);
+            c_pn = saturating_add(th_pn - pn, child_pn[best], INF);
+        }
+        board.make_move(moves[best]);
+        mid(board, !or_node, c_pn, c_dn, child_pn[best], child_dn[best]);
+        board.unmake_to(start);
+    }
+
+    store(key, pn, dn, nodes_ - work_start + 1);
+}
+
+uint64_t DFPNSolver::proof_tree(Board& board, bool or_node, NodeTable& seen,
+                                std::vector<Move>* line) {
+    uint64_t key = board.hash();
+    if (seen.find(key) != NodeTable::NOT_FOUND) return 0;
+    seen.insert(key, 0);
+
+    Move moves[BOARD_CELLS];
+    uint32_t child_pn[BOARD_CELLS], child_dn[BOARD_CELLS];
+    uint32_t pn, dn;
+    int n = generate(board, or_node, moves, child_pn, child_dn, pn, dn);
+    if (n < 0) {
+        if (line && moves[0].is_valid()) line->push_back(moves[0]);
+        return 1;
+    }
+
+    // The attacker needs one proven child, the defender's are all proven;
+    // children evicted from the table are not counted
+    uint64_t size = 1;
+    int start = board.move_count();
+    for (int i = 0; i < n; ++i) {
+        board.make_move(moves[i]);
+        const Entry* entry = lookup(board.hash());
+        bool proven = entry ? entry->pn == 0 : child_pn[i] == 0;
+        if (proven) {
+            if (line) line->push_back(moves[i]);
+            size += proof_tree(board, !or_node, seen, line);
+            line = nullptr;
+        }
+        board.unmake_to(start);
+        if (proven && or_node) break;
+    }
+    return size;
+}
+
+} // namespace gomoku
@@ -3,137 +3,168 @@
 
 namespace gomoku {
 
-Heuristic::Heuristic() {
-    init_pattern_table();
-}
+namespace {
 
-void Heuristic::init_pattern_table() {
-    pattern_table_.fill(0);
-}
+// Cell states in a window code, relative to one colour
+constexpr int REL_FREE = 0;
+constexpr int REL_OWN = 1;
+constexpr int REL_BLOCKED = 2;  // Opponent stone or off the board
 
-int Heuristic::count_consecutive(const Board& board, int x, int y, int dx, int dy, int8_t player) const {
-    int count = 0;
-    int nx = x + dx;
-    int ny = y + dy;
-    while (nx >= 0 && nx < BOARD_SIZE && ny >= 0 && ny < BOARD_SIZE) {
-        if (board.get(nx, ny) != player) break;
-        count++;
-        nx += dx;
-        ny += dy;
-    }
-    return count;
-}
-
-int Heuristic::count_space(const Board& board, int x, int y, int dx, int dy) const {
-    int space = 0;
-    int nx = x + dx;
-    int ny = y + dy;
-    while (nx >= 0 && nx < BOARD_SIZE && ny >= 0 && ny < BOARD_SIZE && space < 5) {
-        if (board.get(nx, ny) != EMPTY) break;
-        space++;
-        nx += dx;
-        ny += dy;
-    }
-    return space;
-}
-
-// Evaluate a line from position (x,y) in direction (dx,dy) for player
-// Returns score based on pattern found
-int Heuristic::evaluate_line(const Board& board, int x, int y, int dx, int dy, int8_t player) const {
-    int8_t opponent = (player == BLACK) ? WHITE : BLACK;
-    
-    // Count consecutive stones in both directions
-    int count_pos = count_consecutive(board, x, y, dx, dy, player);
-    int count_neg = count_consecutive(board, x, y, -dx, -dy, player);
+// Pattern class of a candidate move for one colour, from the 4 cells on
+// either side of it along a line (index 0 is adjacent). The rules are the
+// original ray-walking ones; none of them looks more than 4 cells out, so
+// the window reproduces them exactly.
+constexpr int classify_window(const int (&neg)[PATTERN_REACH], const int (&pos)[PATTERN_REACH]) {
+    int count_pos = 0;
+    while (count_pos < PATTERN_REACH && pos[count_pos] == REL_OWN) count_pos++;
+    int count_neg = 0;
+    while (count_neg < PATTERN_REACH && neg[count_neg] == REL_OWN) count_neg++;
     int total = count_pos + count_neg;
     
-    if (total >= 4) return SCORE_WIN;
-    
-    // Check openness (space at both ends)
-    // Positive direction end
-    int end_pos_x = x + dx * (count_pos + 1);
-    int end_pos_y = y + dy * (count_pos + 1);
-    bool open_pos = (end_pos_x >= 0 && end_pos_x < BOARD_SIZE && 
-                     end_pos_y >= 0 && end_pos_y < BOARD_SIZE &&
-                     board.get(end_pos_x, end_pos_y) == EMPTY);
-    
-    // Negative direction end
-    int end_neg_x = x - dx * (count_neg + 1);
-    int end_neg_y = y - dy * (count_neg + 1);
-    bool open_neg = (end_neg_x >= 0 && end_neg_x < BOARD_SIZE && 
-                     end_neg_y >= 0 && end_neg_y < BOARD_SIZE &&
-                     board.get(end_neg_x, end_neg_y) == EMPTY);
+    if (total >= 4) return LINE_WIN;
     
+    // Openness: the cell just past each run is empty
+    bool open_pos = pos[count_pos] == REL_FREE;
+    bool open_neg = neg[count_neg] == REL_FREE;
     int openness = (open_pos ? 1 : 0) + (open_neg ? 1 : 0);
     
-    // Also check for "gapped" patterns like X_XX or XX_X
-    // Check if there's a stone with a gap in positive direction
+    // Stones beyond a one-cell gap (X_XX, XX_X)
     int gap_count = 0;
-    if (open_pos && count_pos < 4) {
-        // Check beyond the empty space
-        int gap_x = end_pos_x + dx;
-        int gap_y = end_pos_y + dy;
-        while (gap_x >= 0 && gap_x < BOARD_SIZE && gap_y >= 0 && gap_y < BOARD_SIZE) {
-            if (board.get(gap_x, gap_y) == player) {
-                gap_count++;
-                gap_x += dx;
-                gap_y += dy;
-            } else {
-                break;
-            }
-        }
+    if (open_pos) {
+        for (int i = count_pos + 1; i < PATTERN_REACH && pos[i] == REL_OWN; i++) gap_count++;
     }
-    
-    // Check gap in negative direction
     int gap_count_neg = 0;
-    if (open_neg && count_neg < 4) {
-        int gap_x = end_neg_x - dx;
-        int gap_y = end_neg_y - dy;
-        while (gap_x >= 0 && gap_x < BOARD_SIZE && gap_y >= 0 && gap_y < BOARD_SIZE) {
-            if (board.get(gap_x, gap_y) == player) {
-                gap_count_neg++;
-                gap_x -= dx;
-                gap_y -= dy;
-            } else {
-                break;
-            }
-        }
+    if (open_neg) {
+        for (int i = count_neg + 1; i < PATTERN_REACH && neg[i] == REL_OWN; i++) gap_count_neg++;
     }
     
-    int total_with_gaps = total + gap_count + gap_count_neg;
-    
-    // Scoring based on pattern
     if (total == 3) {
-        if (openness == 2) return SCORE_FOUR_OPEN; // Open four potential (critical!)
-        if (openness == 1) return SCORE_FOUR_CLOSED;
+        if (openness == 2) return LINE_FOUR_OPEN;
+        if (openness == 1) return LINE_FOUR_CLOSED;
     }
     
     if (total == 2) {
-        // Check for gapped three (X_XX pattern after this move)
-        if (gap_count >= 1 || gap_count_neg >= 1) {
-            if (openness >= 1) return SCORE_THREE_OPEN; // Broken three is still a threat
-        }
-        if (openness == 2) return SCORE_THREE_OPEN;
-        if (openness == 1) return SCORE_THREE_CLOSED;
+        // Broken three is still a threat
+        if ((gap_count >= 1 || gap_count_neg >= 1) && openness >= 1) return LINE_THREE_OPEN;
+        if (openness == 2) return LINE_THREE_OPEN;
+        if (openness == 1) return LINE_THREE_CLOSED;
     }
     
     if (total == 1) {
-        // Two with gap potential
-        if (gap_count >= 2 || gap_count_neg >= 2) {
-            return SCORE_THREE_CLOSED; // XX_X or X_XX pattern
+        if (gap_count >= 2 || gap_count_neg >= 2) return LINE_THREE_CLOSED;
+        if ((gap_count >= 1 || gap_count_neg >= 1) && openness >= 1) return LINE_TWO_OPEN;
+        if (openness == 2) return LINE_TWO_OPEN;
+        if (openness == 1) return LINE_TWO_CLOSED;
+    }
+    
+    return LINE_NONE;
+}
+
+// Cells that would complete five for one colour once it has played the
+// candidate, as a mask over the 8 window cells (bit k = window cell k, cells
+// -4..-1 then +1..+4). Exact, including broken fours (X_XXX, XX_XX) and
+// the ones the scoring rules above do not classify as fours.
+constexpr int window_gains(const int (&neg)[PATTERN_REACH], const int (&pos)[PATTERN_REACH]) {
+    // Line of 9 cells with the candidate (own) in the middle
+    int line[2 * PATTERN_REACH + 1] = {};
+    for (int i = 0; i < PATTERN_REACH; i++) {
+        line[PATTERN_REACH - 1 - i] = neg[i];
+        line[PATTERN_REACH + 1 + i] = pos[i];
+    }
+    line[PATTERN_REACH] = REL_OWN;
+    
+    int gains = 0;
+    for (int start = 0; start <= PATTERN_REACH; start++) {
+        int own = 0, free = 0, gap = -1;
+        for (int i = start; i < start + 5; i++) {
+            if (line[i] == REL_OWN) own++;
+            if (line[i] == REL_FREE) { free++; gap = i; }
         }
-        if (gap_count >= 1 || gap_count_neg >= 1) {
-            if (openness >= 1) return SCORE_TWO_OPEN;
+        if (own == 4 && free == 1) {
+            gains |= 1 << (gap < PATTERN_REACH ? gap : gap - 1);
         }
-        if (openness == 2) return SCORE_TWO_OPEN;
-        if (openness == 1) return SCORE_TWO_CLOSED;
     }
-    
-    if (total == 0 && openness >= 1) {
-        return 0;  // Space bonus handled separately in cluster_bonus
+    return gains;
+}
+
+constexpr int relative_state(int cell, int own) {
+    if (cell == CELL_EMPTY) return REL_FREE;
+    return cell == own ? REL_OWN : REL_BLOCKED;
+}
+
+constexpr int RELATIVE_CODES = 81 * 81;  // 3^8 own/free/blocked windows
+
+// Class for every colour-relative window, base 3 in the same cell order as
+// the window code (cells -4..-1 in the low four digits, +1..+4 above)
+constexpr std::array<uint8_t, RELATIVE_CODES> build_relative_table() {
+    std::array<uint8_t, RELATIVE_CODES> table{};
+    for (int code = 0; code < RELATIVE_CODES; code++) {
+        int neg[PATTERN_REACH] = {}, pos[PATTERN_REACH] = {};
+        int rest = code;
+        for (int i = PATTERN_REACH - 1; i >= 0; i--) { neg[i] = rest % 3; rest /= 3; }
+        for (int i = 0; i < PATTERN_REACH; i++) { pos[i] = rest % 3; rest /= 3; }
+        table[code] = static_cast<uint8_t>(classify_window(neg, pos));
     }
-    
-    return 0;
+    return table;
+}
+
+constexpr std::array<uint8_t, RELATIVE_CODES> build_relative_gains() {
+    std::array<uint8_t, RELATIVE_CODES> table{};
+    for (int code = 0; code < RELATIVE_CODES; code++) {
+        int neg[PATTERN_REACH] = {}, pos[PATTERN_REACH] = {};
+        int rest = code;
+        for (int i = PATTERN_REACH - 1; i >= 0; i--) { neg[i] = rest % 3; rest /= 3; }
+        for (int i = 0; i < PATTERN_REACH; i++) { pos[i] = rest % 3; rest /= 3; }
+        table[code] = static_cast<uint8_t>(window_gains(neg, pos));
+    }
+    return table;
+}
+
+// Base-3 relative code of one 4-cell half window, for the given colour
+constexpr int relative_half(int half, int own) {
+    int code = 0;
+    for (int i = PATTERN_REACH - 1; i >= 0; i--) {
+        code = code * 3 + relative_state((half >> (2 * i)) & 3, own);
+    }
+    return code;
+}
+
+constexpr std::array<uint8_t, PATTERN_CODES> build_pattern_table() {
+    constexpr auto relative = build_relative_table();
+    std::array<uint8_t, PATTERN_CODES> table{};
+    for (int code = 0; code < PATTERN_CODES; code++) {
+        int neg = code & 0xFF;
+        int pos = code >> 8;
+        int black = relative[relative_half(neg, CELL_BLACK) + 81 * relative_half(pos, CELL_BLACK)];
+        int white = relative[relative_half(neg, CELL_WHITE) + 81 * relative_half(pos, CELL_WHITE)];
+        table[code] = static_cast<uint8_t>(black | (white << 4));
+    }
+    return table;
+}
+
+constexpr std::array<uint16_t, PATTERN_CODES> build_gains_table() {
+    constexpr auto relative = build_relative_gains();
+    std::array<uint16_t, PATTERN_CODES> table{};
+    for (int code = 0; code < PATTERN_CODES; code++) {
+        int neg = code & 0xFF;
+        int pos = code >> 8;
+        int black = relative[relative_half(neg, CELL_BLACK) + 81 * relative_half(pos, CELL_BLACK)];
+        int white = relative[relative_half(neg, CELL_WHITE) + 81 * relative_half(pos, CELL_WHITE)];
+        table[code] = static_cast<uint16_t>(black | (white << 8));
+    }
+    return table;
+}
+
+} // namespace
+
+// Generated at compile time from the scoring rules above
+constexpr std::array<uint8_t, PATTERN_CODES> Heuristic::pattern_table_ = build_pattern_table();
+constexpr std::array<uint16_t, PATTERN_CODES> Heuristic::gains_table_ = build_gains_table();
+
+Heuristic::Heuristic() {}
+
+int Heuristic::pattern_score(int code, int8_t player) {
+    return LINE_CLASS_SCORE[line_class(code, player)];
 }
 
 int Heuristic::cluster_bonus(const Board& board, const Move& move) const {
@@ -141,22 +172,21 @@ int Heuristic::cluster_bonus(const Board& board, const Move& move) const {
     int empty_count = 0;
     int8_t player = board.current_player();
 
-    // Count nearby stones (only friendly) for clustering and empty squares for space
-    for (int dx = -2; dx <= 2; dx++) {
-        for (int dy = -2; dy <= 2; dy++) {
-            if (dx == 0 && dy == 0) continue;
-            int nx = move.x + dx;
-            int ny = move.y + dy;
-            if (nx >= 0 && nx < BOARD_SIZE && ny >= 0 && ny < BOARD_SIZE) {
-                int8_t cell = board.get(nx, ny);
-                if (cell == player) {
-                    // Closer friendly stones give more bonus
-                    int dist = std::max(std::abs(dx), std::abs(dy));
-                    bonus += SCORE_CLUSTER * (3 - dist);
-                } else if (cell == EMPTY) {
-                    // Count empty squares for space bonus
-                    empty_count++;
-                }
+    // Count nearby stones (only friendly) for clustering and empty squares for
+    // space, over the 5x5 window clipped to the board
+    int x_lo = std::max(move.x - 2, 0), x_hi = std::min(move.x + 2, BOARD_SIZE - 1);
+    int y_lo = std::max(move.y - 2, 0), y_hi = std::min(move.y + 2, BOARD_SIZE - 1);
+    for (int ny = y_lo; ny <= y_hi; ny++) {
+        for (int nx = x_lo; nx <= x_hi; nx++) {
+            if (nx == move.x && ny == move.y) continue;
+            int8_t cell = board.get(nx, ny);
+            if (cell == player) {
+                // Closer friendly stones give more bonus
+                int dist = std::max(std::abs(nx - move.x), std::abs(ny - move.y));
+                bonus += SCORE_CLUSTER * (3 - dist);
+            } else if (cell == EMPTY) {
+                // Count empty squares for space bonus
+                empty_count++;
             }
         }
     }
@@ -173,15 +203,15 @@ int Heuristic::evaluate_move(const Board& board, const Move& move) const {
     int defensive = 0;
     
     // Directions: horizontal, vertical, diagonal, anti-diagonal
-    const int dx[] = {1, 0, 1, 1};
-    const int dy[] = {0, 1, 1, -1};
-    
     for (int d = 0; d < 4; d++) {
+        // One window lookup scores the line for both colours
+        int code = board.window_code(move.to_index(), d);
+        
         // Offensive: how good is this move for us
-        offensive += evaluate_line(board, move.x, move.y, dx[d], dy[d], player);
+        offensive += pattern_score(code, player);
         
         // Defensive: how good would this move be for opponent
-        defensive += evaluate_line(board, move.x, move.y, dx[d], dy[d], opponent);
+        defensive += pattern_score(code, opponent);
     }
     
     // Defensive bonus slightly higher to encourage blocking
@@ -197,12 +227,10 @@ ScoredMove Heuristic::score_move(const Board& board, const Move& move) const {
     int offensive = 0;
     int defensive = 0;
     
-    const int dx[] = {1, 0, 1, 1};
-    const int dy[] = {0, 1, 1, -1};
-    
     for (int d = 0; d < 4; d++) {
-        int off_score = evaluate_line(board, move.x, move.y, dx[d], dy[d], player);
-        int def_score = evaluate_line(board, move.x, move.y, dx[d], dy[d], opponent);
+        int code = board.window_code(move.to_index(), d);
+        int off_score = pattern_score(code, player);
+        int def_score = pattern_score(code, opponent);
         
         if (off_score >= SCORE_WIN) {
             sm.is_winning = true;
@@ -220,129 +248,126 @@ ScoredMove Heuristic::score_move(const Board& board, const Move& move) const {
 }
 
 std::vector<ScoredMove> Heuristic::get_scored_moves(const Board& board) const {
-    auto moves = board.get_legal_moves();
     std::vector<ScoredMove> scored;
-    scored.reserve(moves.size());
+    scored.reserve(board.count_legal_moves());
     
-    for (const auto& move : moves) {
+    board.for_each_legal_move([&](const Move& move) {
         scored.push_back(score_move(board, move));
-    }
+    });
     
     std::sort(scored.begin(), scored.end(), std::greater<ScoredMove>());
     return scored;
 }
 
-Move Heuristic::find_winning_move(const Board& board) const {
-    int8_t player = board.current_player();
-    auto moves = board.get_legal_moves();
-    
-    const int dx[] = {1, 0, 1, 1};
-    const int dy[] = {0, 1, 1, -1};
-    
-    // Only look for immediate 5-in-a-row wins
-    for (const auto& move : moves) {
-        for (int d = 0; d < 4; d++) {
-            int count_pos = count_consecutive(board, move.x, move.y, dx[d], dy[d], player);
-            int count_neg = count_consecutive(board, move.x, move.y, -dx[d], -dy[d], player);
-            
-            // With this move placed, we'd have count_pos + 1 + count_neg in a row
-            // Win requires 5 in a row, so count_pos + count_neg >= 4
-            if (count_pos + count_neg >= 4) {
-                return move;
-            }
+int Heuristic::top_moves(const Board& board, int k, ScoredMove* out) const {
+    TopMoves top(out, k);
+    board.for_each_legal_move([&](const Move& move) {
+        top.offer(score_move(board, move));
+    });
+    return top.finish();
+}
+
+void ThreatSummary::add(const Move& move, uint8_t black_classes, uint8_t white_classes) {
+    // Quiet cell: nothing of open three or better for either colour
+    if ((black_classes | white_classes) < (1 << LINE_THREE_OPEN)) return;
+    
+    const uint8_t masks[2] = {black_classes, white_classes};
+    for (int s = 0; s < 2; ++s) {
+        Side& side = sides[s];
+        uint8_t mask = masks[s];
+        if (mask & (1 << LINE_WIN)) {
+            if (!side.five.is_valid()) side.five = move;
+            side.num_fives++;
+        }
+        if ((mask & (1 << LINE_FOUR_OPEN)) && !side.open_four.is_valid()) {
+            side.open_four = move;
+        }
+        // Highest class through this cell; keep the first strongest
+        auto best = static_cast<LineClass>(31 - __builtin_clz(mask));
+        if (best >= LINE_THREE_OPEN && best > side.strongest_class) {
+            side.strongest = move;
+            side.strongest_class = best;
         }
     }
-    
-    return Move(-1, -1);
+}
+
+Move ThreatSummary::forced_move(int8_t player) const {
+    const Side& me = of(player);
+    const Side& opponent = of(-player);
+    if (me.five.is_valid()) return me.five;
+    if (opponent.five.is_valid()) return opponent.five;
+    return me.open_four;
+}
+
+ThreatSummary Heuristic::classify_threats(const Board& board) const {
+    ThreatSummary threats;
+    board.for_each_legal_move([&](const Move& move) {
+        uint8_t black, white;
+        line_classes(board, move.to_index(), black, white);
+        threats.add(move, black, white);
+    });
+    return threats;
+}
+
+Move Heuristic::find_winning_move(const Board& board) const {
+    // Only look for immediate 5-in-a-row wins
+    return classify_threats(board).of(board.current_player()).five;
 }
 
 Move Heuristic::find_open_four_move(const Board& board) const {
-    int8_t player = board.current_player();
-    auto moves = board.get_legal_moves();
-    
-    const int dx[] = {1, 0, 1, 1};
-    const int dy[] = {0, 1, 1, -1};
-    
-    // Look for moves that create open four (unstoppable win)
     // An open four is 4 in a row with BOTH ends empty - opponent can't block both
-    for (const auto& move : moves) {
-        for (int d = 0; d < 4; d++) {
-            int count_pos = count_consecutive(board, move.x, move.y, dx[d], dy[d], player);
-            int count_neg = count_consecutive(board, move.x, move.y, -dx[d], -dy[d], player);
-            
-            // Check if this creates exactly 4 in a row (count_pos + count_neg == 3)
-            if (count_pos + count_neg == 3) {
-                // Check if both ends are open
-                int end_pos_x = move.x + dx[d] * (count_pos + 1);
-                int end_pos_y = move.y + dy[d] * (count_pos + 1);
-                int end_neg_x = move.x - dx[d] * (count_neg + 1);
-                int end_neg_y = move.y - dy[d] * (count_neg + 1);
-                
-                bool open_pos = (end_pos_x >= 0 && end_pos_x < BOARD_SIZE && 
-                                 end_pos_y >= 0 && end_pos_y < BOARD_SIZE &&
-                                 board.get(end_pos_x, end_pos_y) == EMPTY);
-                bool open_neg = (end_neg_x >= 0 && end_neg_x < BOARD_SIZE && 
-                                 end_neg_y >= 0 && end_neg_y < BOARD_SIZE &&
-                                 board.get(end_neg_x, end_neg_y) == EMPTY);
-                
-                // Open four = guaranteed win (opponent can only block one side)
-                if (open_pos && open_neg) {
-                    return move;
-                }
-            }
-        }
-    }
-    
-    return Move(-1, -1);
+    return classify_threats(board).of(board.current_player()).open_four;
 }
 
 Move Heuristic::find_blocking_move(const Board& board) const {
-    int8_t player = board.current_player();
-    int8_t opponent = (player == BLACK) ? WHITE : BLACK;
-    auto moves = board.get_legal_moves();
-    
-    const int dx[] = {1, 0, 1, 1};
-    const int dy[] = {0, 1, 1, -1};
-    
     // ONLY block immediate threats: opponent's 4-in-a-row that would win next turn
-    for (const auto& move : moves) {
-        for (int d = 0; d < 4; d++) {
-            int count_pos = count_consecutive(board, move.x, move.y, dx[d], dy[d], opponent);
-            int count_neg = count_consecutive(board, move.x, move.y, -dx[d], -dy[d], opponent);
-            if (count_pos + count_neg >= 4) {
-                return move;
-            }
+    return classify_threats(board).of(-board.current_player()).five;
+}
+
+Move Heuristic::find_open_three_block(const Board& board) const {
+    // The opponent's strongest line of open three or better (an open three
+    // would become an open four if not blocked)
+    return classify_threats(board).of(-board.current_player()).strongest;
+}
+
+int Heuristic::five_cells(const Board& board, int idx, int8_t player, int* out) {
+    int n = 0;
+    for (int dir = 0; dir < 4; ++dir) {
+        uint8_t gains = four_gains(board.window_code(idx, dir), player);
+        while (gains) {
+            out[n++] = window_cell(idx, dir, __builtin_ctz(gains));
+            gains &= gains - 1;
         }
     }
-    
-    return Move(-1, -1);
+    return n;
 }
 
-Move Heuristic::find_open_three_block(const Board& board) const {
-    int8_t player = board.current_player();
-    int8_t opponent = (player == BLACK) ? WHITE : BLACK;
-    auto moves = board.get_legal_moves();
-    
-    const int dx[] = {1, 0, 1, 1};
-    const int dy[] = {0, 1, 1, -1};
-    
-    // Find opponent's open threes that would become open fours if not blocked
-    Move best_block(-1, -1);
-    int best_threat = 0;
-    
-    for (const auto& move : moves) {
-        for (int d = 0; d < 4; d++) {
-            int threat = evaluate_line(board, move.x, move.y, dx[d], dy[d], opponent);
-            // SCORE_FOUR_OPEN indicates this move would complete an open four for opponent
-            // SCORE_THREE_OPEN indicates opponent has open three in this direction
-            if (threat >= SCORE_THREE_OPEN && threat > best_threat) {
-                best_threat = threat;
-                best_block = move;
-            }
+int Heuristic::count_stones(int code, int8_t player) {
+    int low = code & 0x5555;
+    int high = (code >> 1) & 0x5555;
+    return __builtin_popcount(player == BLACK ? low & ~high : high & ~low);
+}
+
+bool Heuristic::new_double_five(const Board& board, int idx, int8_t player) {
+    int cells[MAX_FIVE_CELLS];
+    for (int dir = 0; dir < 4; ++dir) {
+        int code = board.window_code(idx, dir);
+        if (count_stones(code, player) < 2) continue;
+        for (int k = 0; k < 2 * PATTERN_REACH; ++k) {
+            if (((code >> (2 * k)) & 3) != CELL_EMPTY) continue;
+            if (five_cells(board, window_cell(idx, dir, k), player, cells) >= 2) return true;
         }
     }
-    
-    return best_block;
+    return false;
+}
+
+void Heuristic::line_classes(const Board& board, int idx, uint8_t& black, uint8_t& white) {
+    black = white = 0;
+    for (int dir = 0; dir < 4; ++dir) {
+        uint8_t entry = pattern_table_[board.window_code(idx, dir)];
+        black |= uint8_t(1) << (entry & 0xF);
+        white |= uint8_t(1) << (entry >> 4);
+    }
 }
 
 } // namespace gomoku
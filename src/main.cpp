@@ -1,6 +1,8 @@
 #include "uci.hpp"
 #include "board.hpp"
 #include "mcts.hpp"
+#include "time_manager.hpp"
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <thread>
@@ -33,7 +35,9 @@ std::string move_to_str(const gomoku::Move& move) {
     return std::string(1, col) + std::to_string(row);
 }
 
-void demo_game(int movetime_ms) {
+// Self-play with a fixed time per move, or with a clock per side
+// (clock.time_ms > 0) that the time manager spends
+void demo_game(int movetime_ms, const gomoku::TimeControl& clock) {
     using namespace gomoku;
     
     Board board;
@@ -41,13 +45,19 @@ void demo_game(int movetime_ms) {
     config.max_time_ms = movetime_ms;
     config.max_iterations = 100000;
     MCTS mcts(config);
+    TimeManager time_manager;
+    bool use_clock = clock.time_ms > 0;
+    int clock_ms[2] = {clock.time_ms, clock.time_ms};  // BLACK, WHITE
+    std::string time_str = use_clock
+        ? std::to_string(clock.time_ms) + "ms per side + " + std::to_string(clock.increment_ms) + "ms per move"
+        : std::to_string(movetime_ms) + "ms per move";
     
     // Create log file
     std::string filename = "game_" + get_timestamp() + ".txt";
     std::ofstream log_file(filename);
     
     std::cout << "=== Gomoku Demo Game ===" << std::endl;
-    std::cout << "Search time: " << movetime_ms << "ms per move" << std::endl;
+    std::cout << "Search time: " << time_str << std::endl;
     std::cout << "Game log: " << filename << std::endl;
     std::cout << "Press Ctrl+C to stop" << std::endl;
     std::cout << std::endl;
@@ -58,21 +68,41 @@ void demo_game(int movetime_ms) {
     log_file << "         GOMOKU GAME LOG" << std::endl;
     log_file << "========================================" << std::endl;
     log_file << "Date: " << get_timestamp() << std::endl;
-    log_file << "Search time: " << movetime_ms << "ms per move" << std::endl;
+    log_file << "Search time: " << time_str << std::endl;
     log_file << "----------------------------------------" << std::endl;
     log_file << std::endl;
     
     int move_num = 0;
     std::vector<std::string> move_list;
+    int8_t flagged = EMPTY;  // Side whose clock ran out
     
     while (!board.is_terminal()) {
         ++move_num;
         
         // Search for best move
+        int side = board.current_player() == BLACK ? 0 : 1;
         auto start = std::chrono::high_resolution_clock::now();
-        Move best = mcts.search(board, movetime_ms);
+        Move best;
+        if (use_clock) {
+            TimeControl control = clock;
+            control.time_ms = clock_ms[side];
+            TimeBudget budget = time_manager.allocate(control, board.move_count());
+            best = mcts.search(board, budget.target_ms, budget.max_ms);
+        } else {
+            best = mcts.search(board, movetime_ms);
+        }
         auto end = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+        if (use_clock) {
+            clock_ms[side] -= static_cast<int>(duration);
+            if (clock_ms[side] < 0) {
+                // The move came too late and is not played
+                flagged = board.current_player();
+                --move_num;
+                break;
+            }
+            clock_ms[side] += clock.increment_ms;
+        }
         
         std::string player_name = (board.current_player() == BLACK) ? "BLACK (X)" : "WHITE (O)";
         std::string move_str = move_to_str(best);
@@ -90,6 +120,9 @@ void demo_game(int movetime_ms) {
         std::cout << std::endl;
         std::cout << "Move " << move_num << ": " << player_name << " plays " << move_str;
         std::cout << " (" << duration << "ms, " << mcts.get_iterations() << " iterations)" << std::endl;
+        if (use_clock) {
+            std::cout << "Clocks: BLACK " << clock_ms[0] << "ms, WHITE " << clock_ms[1] << "ms" << std::endl;
+        }
         std::cout << std::endl;
         
         // Print move history
@@ -129,8 +162,14 @@ void demo_game(int movetime_ms) {
         default:
             result_str = "Unknown";
     }
+    if (flagged != EMPTY) {
+        result_str = flagged == BLACK ? "WHITE (O) WINS ON TIME!" : "BLACK (X) WINS ON TIME!";
+    }
     std::cout << "GAME OVER: " << result_str << std::endl;
     std::cout << "Total moves: " << move_num << std::endl;
+    std::cout << "Forced moves (no search): " << mcts.get_short_circuits()
+              << " (VCF wins: " << mcts.get_vcf_wins()
+              << ", VCT wins: " << mcts.get_vct_wins() << ")" << std::endl;
     std::cout << "========================================" << std::endl;
     
     // Log final result
@@ -138,6 +177,9 @@ void demo_game(int movetime_ms) {
     log_file << "----------------------------------------" << std::endl;
     log_file << "RESULT: " << result_str << std::endl;
     log_file << "Total moves: " << move_num << std::endl;
+    log_file << "Forced moves (no search): " << mcts.get_short_circuits()
+           << " (VCF wins: " << mcts.get_vcf_wins()
+           << ", VCT wins: " << mcts.get_vct_wins() << ")" << std::endl;
     log_file << "----------------------------------------" << std::endl;
     log_file << std::endl;
     log_file << "Final position:" << std::endl;
@@ -167,6 +209,7 @@ void print_usage(const char* program) {
     std::cout << "  (no args)     Start UCI mode (interactive)" << std::endl;
     std::cout << "  demo          Play a demo game (self-play)" << std::endl;
     std::cout << "  demo <ms>     Demo with custom think time (default: 1000ms)" << std::endl;
+    std::cout << "  demo clock <ms> [inc]  Demo with a clock per side, spent by the time manager" << std::endl;
     std::cout << "  --help, -h    Show this help message" << std::endl;
     std::cout << std::endl;
     std::cout << "UCI Commands (in interactive mode):" << std::endl;
@@ -174,6 +217,8 @@ void print_usage(const char* program) {
     std::cout << "  isready       Check if ready" << std::endl;
     std::cout << "  position startpos [moves ...]" << std::endl;
     std::cout << "  go movetime <ms>" << std::endl;
+    std::cout << "  go btime <ms> wtime <ms> [binc <ms>] [winc <ms>] [movestogo <n>]" << std::endl;
+    std::cout << "  solve [nodes <n>] [movetime <ms>]  Prove a win for the side to move" << std::endl;
     std::cout << "  d             Display board" << std::endl;
     std::cout << "  quit          Exit" << std::endl;
 }
@@ -182,11 +227,16 @@ int main(int argc, char* argv[]) {
     if (argc > 1) {
         if (std::strcmp(argv[1], "demo") == 0) {
             int movetime = 1000;
-            if (argc > 2) {
+            gomoku::TimeControl clock;
+            if (argc > 2 && std::strcmp(argv[2], "clock") == 0) {
+                clock.time_ms = argc > 3 ? std::atoi(argv[3]) : 0;
+                if (clock.time_ms <= 0) clock.time_ms = 60000;
+                clock.increment_ms = argc > 4 ? std::max(0, std::atoi(argv[4])) : 0;
+            } else if (argc > 2) {
                 movetime = std::atoi(argv[2]);
                 if (movetime <= 0) movetime = 1000;
             }
-            demo_game(movetime);
+            demo_game(movetime, clock);
             return 0;
         } else if (std::strcmp(argv[1], "--help") == 0 || std::strcmp(argv[1], "-h") == 0) {
             print_usage(argv[0]);
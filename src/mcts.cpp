@@ -2,10 +2,68 @@
 #include <cmath>
 #include <algorithm>
 #include <limits>
+#include <thread>
+#include <memory>
 
 namespace gomoku {
 
-MCTS::MCTS(const MCTSConfig& config) : config_(config), iterations_(0) {
+namespace {
+
+void atomic_add(std::atomic<double>& target, double delta) {
+    double current = target.load(std::memory_order_relaxed);
+    while (!target.compare_exchange_weak(current, current + delta, std::memory_order_relaxed)) {}
+}
+
+void atomic_add(std::atomic<float>& target, float delta) {
+    float current = target.load(std::memory_order_relaxed);
+    while (!target.compare_exchange_weak(current, current + delta, std::memory_order_relaxed)) {}
+}
+
+} // namespace
+
+template <typename Scorer>
+int MCTS::order_moves(const Scorer& scorer, const Board& board, ScoredMove* ordered,
+                      bool& forced) const {
+    Move move = scorer.classify_threats(board).forced_move(board.current_player());
+    forced = move.is_valid();
+    if (forced) {
+        ordered[0] = ScoredMove(move, 0);
+        return 1;
+    }
+    int k = config_.max_children > 0 ? std::min(config_.max_children, BOARD_CELLS) : BOARD_CELLS;
+    return scorer.top_moves(board, k, ordered);
+}
+
+MCTSNode& MCTSNode::operator=(const MCTSNode& other) {
+    hash = other.hash;
+    first_edge.store(other.first_edge.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    num_edges.store(other.num_edges.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    all_moves.store(other.all_moves.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    num_expanded.store(other.num_expanded.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    visit_count.store(other.visit_count.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    total_value.store(other.total_value.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    virtual_loss.store(0, std::memory_order_relaxed);
+    expanding.store(false, std::memory_order_relaxed);
+    proof.store(other.proof.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    player_to_move = other.player_to_move;
+    is_terminal_node = other.is_terminal_node;
+    terminal_value = other.terminal_value;
+    return *this;
+}
+
+MCTSEdge& MCTSEdge::operator=(const MCTSEdge& other) {
+    move = other.move;
+    child = other.child;
+    prior = other.prior;
+    amaf_visits.store(other.amaf_visits.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    amaf_total.store(other.amaf_total.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    return *this;
+}
+
+MCTS::MCTS(const MCTSConfig& config)
+    : config_(config), iterations_(0), iteration_limit_(0), transpositions_(0),
+      extensions_(0), short_circuits_(0), vcf_wins_(0), vct_wins_(0),
+      answer_(SearchAnswer::SEARCH), root_(NO_NODE) {
     if (config_.seed == 0) {
         rng_.seed(std::chrono::high_resolution_clock::now().time_since_epoch().count());
     } else {
@@ -18,275 +76,905 @@ Move MCTS::search(const Board& board) {
 }
 
 Move MCTS::search(const Board& board, int time_limit_ms) {
-    // Create root node - let MCTS explore fully instead of short-circuiting
-    auto root = std::make_unique<MCTSNode>(Move(), nullptr, board.current_player());
-    init_untried_moves(root.get(), board);
+    return search(board, time_limit_ms, time_limit_ms);
+}
+
+Move MCTS::search(const Board& board, int time_limit_ms, int max_time_ms) {
+    auto start = std::chrono::high_resolution_clock::now();
+    iterations_ = 0;
+    transpositions_ = 0;
+    extensions_ = 0;
+    answer_ = SearchAnswer::SEARCH;
+    
+    // Moves answered before building anything keep the previous tree for
+    // the next search to walk down, but the getters report no tree for them
+    auto answer_without_tree = [this](SearchAnswer answer, Move move) {
+        ++short_circuits_;
+        answer_ = answer;
+        return move;
+    };
+    
+    // Forced moves (win, block a five, open four) are answered before
+    // building anything: select_best_move would play them over any search
+    // result, so the time budget is left unspent
+    Move forced = heuristic_.classify_threats(board).forced_move(board.current_player());
+    if (forced.is_valid()) {
+        return answer_without_tree(SearchAnswer::FORCED, forced);
+    }
+    
+    // A win by continuous fours, then by continuous threats, is played out
+    // without searching either; the VCT check gets a slice of the move time
+    Board scratch = board;
+    if (config_.vcf_root_nodes > 0) {
+        vcf_.set_node_budget(config_.vcf_root_nodes);
+        VCFResult vcf = vcf_.solve(scratch);
+        if (vcf.proven) {
+            ++vcf_wins_;
+            return answer_without_tree(SearchAnswer::VCF, vcf.line.front());
+        }
+    }
+    if (config_.vct_root_nodes > 0) {
+        vct_.set_node_budget(config_.vct_root_nodes);
+        vct_.set_time_limit(std::max(1, std::min(config_.vct_root_ms, time_limit_ms / 4)));
+        VCTResult vct = vct_.solve(scratch);
+        if (vct.proven) {
+            ++vct_wins_;
+            return answer_without_tree(SearchAnswer::VCT, vct.line.front());
+        }
+    }
+    
+    NodeIndex root_idx = prepare_root(board);
+    MCTSNode* root = nodes_.ptr(root_idx);
     
     // If only one legal move, return it
-    if (root->untried_moves.size() == 1) {
-        return root->untried_moves[0];
+    if (root->edge_count() == 1) {
+        ++short_circuits_;
+        answer_ = SearchAnswer::ONLY_MOVE;
+        return edges_of(root)[0].move;
+    }
+    
+    int num_threads = std::max(1, config_.num_threads);
+    bool root_parallel = config_.parallel_mode == ParallelMode::ROOT && num_threads > 1;
+    if (root_parallel) {
+        prepare_root_workers(num_threads);
+    } else {
+        root_workers_.clear();
+        iteration_limit_ = config_.max_iterations;
+    }
+    // Slices run up to deadlines measured from the start of the search, so
+    // the time the root solvers took above counts against the budget; a
+    // slice whose deadline has already passed is skipped
+    auto elapsed_ms = [&] {
+        return static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::high_resolution_clock::now() - start).count());
+    };
+    bool first_slice = true;
+    auto run_slice = [&](int deadline_ms) {
+        int ms = deadline_ms - elapsed_ms();
+        if (ms <= 0) return;
+        if (root_parallel) {
+            search_root_parallel(board, ms, first_slice);
+        } else {
+            run_search(root_idx, board, ms, num_threads);
+        }
+        first_slice = false;
+    };
+    
+    if (max_time_ms <= time_limit_ms) {
+        run_slice(time_limit_ms);
+    } else {
+        // The normal budget in two halves, then another half at a time
+        // while the most visited move differs from the one before it
+        int half = std::max(1, time_limit_ms / 2);
+        run_slice(half);
+        Move before = most_visited_move(root);
+        run_slice(time_limit_ms);
+        Move after = most_visited_move(root);
+        for (;;) {
+            if (after == before || elapsed_ms() >= max_time_ms || root->proof_state() != UNPROVEN ||
+                iterations_.load() >= iteration_limit_) {
+                break;
+            }
+            ++extensions_;
+            before = after;
+            run_slice(std::min(elapsed_ms() + half, max_time_ms));
+            after = most_visited_move(root);
+        }
     }
     
+    // With the budget spent before any slice, root-parallel workers still
+    // hold the trees of their previous search
+    if (first_slice) {
+        root_workers_.clear();
+    }
+    
+    if (root_parallel) {
+        int total = iterations_.load();
+        for (const auto& worker : root_workers_) {
+            total += worker->get_iterations();
+        }
+        iterations_ = total;
+    }
+    
+    return select_best_move(root, board);
+}
+
+NodeIndex MCTS::prepare_root(const Board& board) {
+    // Continue from the previous tree if this position follows from it,
+    // otherwise drop it in O(1) and create a fresh root
+    NodeIndex root_idx = config_.reuse_tree ? advance_root(board) : NO_NODE;
+    if (root_idx == NO_NODE) {
+        nodes_.reset();
+        edges_.reset();
+        table_.clear();
+        ScoredMove ordered[BOARD_CELLS];
+        bool forced = false;
+        int num_ordered = board.is_terminal() ? 0 : order_moves(heuristic_, board, ordered, forced);
+        root_idx = create_node(board, ordered, num_ordered, forced);
+    }
+    root_ = root_idx;
+    root_history_ = board.get_history();
+    return root_idx;
+}
+
+void MCTS::run_search(NodeIndex root_idx, const Board& board, int time_limit_ms, int num_threads) {
     auto start_time = std::chrono::high_resolution_clock::now();
-    iterations_ = 0;
     
-    while (iterations_ < config_.max_iterations) {
+    // Every thread runs the full select/expand/rollout/backpropagate loop on
+    // the shared tree; the calling thread is worker 0
+    std::vector<SearchContext> contexts(num_threads);
+    for (auto& ctx : contexts) {
+        ctx.rng.seed(rng_());
+    }
+    
+    std::vector<std::thread> helpers;
+    for (int t = 1; t < num_threads; ++t) {
+        helpers.emplace_back([&, t] {
+            search_worker(root_idx, board, contexts[t], start_time, time_limit_ms);
+        });
+    }
+    search_worker(root_idx, board, contexts[0], start_time, time_limit_ms);
+    for (auto& helper : helpers) {
+        helper.join();
+    }
+}
+
+void MCTS::prepare_root_workers(int num_threads) {
+    // One independent single-threaded MCTS per extra thread, each with its
+    // own seed and tree (kept between searches like our own)
+    MCTSConfig worker_config = config_;
+    worker_config.num_threads = 1;
+    worker_config.parallel_mode = ParallelMode::TREE;
+    if (static_cast<int>(root_workers_.size()) != num_threads - 1) {
+        root_workers_.clear();
+        for (int t = 1; t < num_threads; ++t) {
+            worker_config.seed = rng_() | 1;
+            root_workers_.push_back(std::make_unique<MCTS>(worker_config));
+        }
+    }
+    
+    // Split the iteration budget; the time budget applies to every tree
+    int share = (config_.max_iterations + num_threads - 1) / num_threads;
+    iteration_limit_ = share;
+    for (auto& worker : root_workers_) {
+        MCTS* w = worker.get();
+        worker_config.seed = w->config_.seed;
+        w->config_ = worker_config;
+        w->iteration_limit_ = share;
+        w->iterations_ = 0;
+        w->transpositions_ = 0;
+    }
+}
+
+void MCTS::search_root_parallel(const Board& board, int time_limit_ms, bool first_slice) {
+    // Workers move to the new position on the first slice of a search
+    std::vector<std::thread> threads;
+    for (auto& worker : root_workers_) {
+        MCTS* w = worker.get();
+        threads.emplace_back([w, &board, time_limit_ms, first_slice] {
+            NodeIndex root = first_slice ? w->prepare_root(board) : w->root_;
+            w->run_search(root, board, time_limit_ms, 1);
+        });
+    }
+    run_search(root_, board, time_limit_ms, 1);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void MCTS::add_root_stats(RootStats& stats) const {
+    if (root_ == NO_NODE) return;
+    const MCTSNode* root = nodes_.ptr(root_);
+    if (root->edge_count() == 0) return;
+    
+    const MCTSEdge* edges = edges_.ptr(root->first_edge);
+    for (int i = 0; i < root->expanded_count(); ++i) {
+        const MCTSNode* child = nodes_.ptr(edges[i].child);
+        int idx = edges[i].move.to_index();
+        stats.visits[idx] += child->visit_count.load(std::memory_order_relaxed);
+        stats.total_value[idx] += child->total_value.load(std::memory_order_relaxed);
+    }
+}
+
+void MCTS::search_worker(NodeIndex root_idx, const Board& board, SearchContext& ctx,
+                         std::chrono::high_resolution_clock::time_point start_time,
+                         int time_limit_ms) {
+    int8_t root_player = board.current_player();
+    int root_moves = board.move_count();
+    
+    // One board per thread: every iteration plays forward from the root
+    // position and is unmade back to it, so nothing is copied or allocated
+    ctx.board = board;
+    Board& sim_board = ctx.board;
+    ctx.path.reserve(BOARD_CELLS);
+    ctx.vcf.set_node_budget(config_.vcf_leaf_nodes);
+    ctx.vct.set_node_budget(config_.vct_leaf_nodes);
+    
+    const MCTSNode* root = nodes_.ptr(root_idx);
+    while (iterations_.load(std::memory_order_relaxed) < iteration_limit_) {
+        // A solved root needs no more playouts
+        if (root->proof_state() != UNPROVEN) break;
+        
         // Check time limit
         auto now = std::chrono::high_resolution_clock::now();
         auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - start_time).count();
         if (elapsed >= time_limit_ms) break;
         
-        // Create a copy of the board for this iteration
-        Board sim_board = board;
-        
         // Selection
-        MCTSNode* node = select(root.get(), sim_board);
+        NodeIndex leaf = select(root_idx, sim_board, ctx);
         
-        // Expansion
-        if (!node->untried_moves.empty() && !sim_board.is_terminal()) {
-            node = expand(node, sim_board);
+        // Expansion - a node proven during selection needs no more children
+        if (nodes_[leaf].may_expand() && !sim_board.is_terminal() &&
+            nodes_[leaf].proof_state() == UNPROVEN) {
+            leaf = expand(leaf, sim_board, ctx);
         }
+        const MCTSNode* node = nodes_.ptr(leaf);
         
-        // Rollout - skip if terminal node (use fixed terminal value)
+        // Rollout - skip if terminal node (use fixed terminal value).
+        // Rollouts score the leaf for its player to move, terminal values are
+        // stored for the player who moved into it; convert to the root player.
         double value;
+        ctx.num_playouts = 0;
         if (node->is_terminal_node) {
-            value = node->terminal_value;
+            value = -node->terminal_value;
+        } else if (node->proof_state() == PROVEN_LOSS) {
+            // Proven in selection: the leaf's player to move has a winning child
+            value = 1.0;
+        } else if ((config_.vcf_leaf_nodes > 0 && ctx.vcf.solve(sim_board).proven) ||
+                   (config_.vct_leaf_nodes > 0 && ctx.vct.solve(sim_board).proven)) {
+            // The leaf's player to move wins by continuous fours/threats
+            value = 1.0;
+            nodes_[leaf].proof.store(PROVEN_LOSS, std::memory_order_release);
         } else {
-            value = rollout(sim_board);
+            value = rollout(sim_board, ctx);
         }
+        if (config_.use_rave) update_amaf(ctx, root_moves, value);
+        if (node->player_to_move != root_player) value = -value;
         
         // Backpropagation
-        backpropagate(node, value, board.current_player());
+        backpropagate(ctx.path, value, root_player);
+        sim_board.unmake_to(root_moves);
         
-        ++iterations_;
+        iterations_.fetch_add(1, std::memory_order_relaxed);
     }
-    
-    return select_best_move(root.get(), board);
+}
+
+ProofState MCTS::get_root_proof() const {
+    return has_tree() ? nodes_[root_].proof_state() : UNPROVEN;
 }
 
 int MCTS::get_root_visits() const {
-    return iterations_;
+    return has_tree() ? nodes_[root_].visit_count.load() : 0;
+}
+
+int MCTS::get_root_children() const {
+    return has_tree() ? nodes_[root_].expanded_count() : 0;
+}
+
+size_t MCTS::get_node_count() const {
+    return has_tree() ? nodes_.size() : 0;
+}
+
+size_t MCTS::get_edge_count() const {
+    return has_tree() ? edges_.size() : 0;
+}
+
+void MCTS::clear_tree() {
+    nodes_.reset();
+    edges_.reset();
+    table_.clear();
+    root_ = NO_NODE;
+    root_history_.clear();
+    root_workers_.clear();
+}
+
+NodeIndex MCTS::advance_root(const Board& board) {
+    const auto& history = board.get_history();
+    if (root_ == NO_NODE || history.size() < root_history_.size() ||
+        !std::equal(root_history_.begin(), root_history_.end(), history.begin())) {
+        return NO_NODE;
+    }
+    
+    // Follow the moves played since the last search down the tree
+    NodeIndex node_idx = root_;
+    for (size_t i = root_history_.size(); i < history.size(); ++i) {
+        const MCTSNode* node = nodes_.ptr(node_idx);
+        const MCTSEdge* edges = edges_of(node);
+        NodeIndex next = NO_NODE;
+        for (int e = 0; e < node->expanded_count(); ++e) {
+            if (edges[e].move == history[i]) {
+                next = edges[e].child;
+                break;
+            }
+        }
+        if (next == NO_NODE) return NO_NODE;
+        node_idx = next;
+    }
+    
+    if (node_idx == root_) return root_;
+    if (nodes_[node_idx].is_terminal_node) return NO_NODE;
+    
+    // Promote the subtree: copy it breadth-first into the spare arenas and
+    // swap them in, which frees everything outside of it. Nodes shared by
+    // transpositions are copied once, found again through the spare table.
+    spare_nodes_.reset();
+    spare_edges_.reset();
+    spare_table_.clear();
+    std::vector<std::pair<NodeIndex, NodeIndex>> queue; // (old, new)
+    NodeIndex new_root = spare_nodes_.allocate(1);
+    spare_table_.insert(nodes_[node_idx].hash, new_root);
+    queue.emplace_back(node_idx, new_root);
+    
+    for (size_t head = 0; head < queue.size(); ++head) {
+        auto [old_idx, new_idx] = queue[head];
+        const MCTSNode& src = nodes_[old_idx];
+        MCTSNode& dst = spare_nodes_[new_idx];
+        dst = src;
+        int num_edges = src.edge_count();
+        if (num_edges == 0) continue;
+        
+        dst.first_edge = spare_edges_.allocate(num_edges);
+        const MCTSEdge* src_edges = edges_of(&src);
+        MCTSEdge* dst_edges = spare_edges_.ptr(dst.first_edge);
+        for (int e = 0; e < num_edges; ++e) {
+            dst_edges[e] = src_edges[e];
+            if (e < src.expanded_count()) {
+                uint64_t key = nodes_[src_edges[e].child].hash;
+                NodeIndex child = config_.use_transpositions ? spare_table_.find(key) : NO_NODE;
+                if (child == NO_NODE) {
+                    child = spare_nodes_.allocate(1);
+                    spare_table_.insert(key, child);
+                    queue.emplace_back(src_edges[e].child, child);
+                }
+                dst_edges[e].child = child;
+            }
+        }
+    }
+    
+    nodes_.swap(spare_nodes_);
+    edges_.swap(spare_edges_);
+    table_.swap(spare_table_);
+    return new_root;
 }
 
-MCTSNode* MCTS::select(MCTSNode* node, Board& board) {
-    while (!node->is_leaf() && node->is_fully_expanded()) {
+NodeIndex MCTS::create_node(const Board& board, const ScoredMove* ordered, int num_ordered,
+                            bool forced) {
+    // Caller holds tree_mutex_ (or is the only thread)
+    NodeIndex idx = nodes_.allocate(1);
+    MCTSNode* node = nodes_.ptr(idx);
+    node->init(board.hash(), board.current_player());
+    
+    // Check if the move into this node ended the game
+    if (board.is_terminal()) {
+        node->is_terminal_node = true;
+        int8_t winner = board.get_winner();
+        if (winner == EMPTY) {
+            node->terminal_value = 0.0; // Draw
+            node->proof.store(PROVEN_DRAW, std::memory_order_relaxed);
+        } else {
+            // Value from the perspective of the player who just moved
+            bool won = winner == -board.current_player();
+            node->terminal_value = won ? 1.0 : -1.0;
+            node->proof.store(won ? PROVEN_WIN : PROVEN_LOSS, std::memory_order_relaxed);
+        }
+    } else {
+        init_untried_moves(node, board, ordered, num_ordered, forced);
+    }
+    
+    table_.insert(node->hash, idx);
+    return idx;
+}
+
+NodeIndex MCTS::select(NodeIndex node_idx, Board& board, SearchContext& ctx) {
+    MCTSNode* node = nodes_.ptr(node_idx);
+    ctx.path.clear();
+    ctx.path.push_back(node_idx);
+    bool puct = config_.selection == SelectionRule::PUCT;
+    while (!node->is_leaf() && (puct || node->expanded_count() >= children_allowed(node))) {
         // Select child with highest UCT value
-        MCTSNode* best_child = nullptr;
+        NodeIndex best_child = NO_NODE;
         double best_uct = -std::numeric_limits<double>::infinity();
         
-        for (const auto& child : node->children) {
-            double uct = uct_value(child.get(), node->visit_count);
+        Move best_move;
+        int num_children = node->expanded_count();
+        int num_edges = node->edge_count();
+        MCTSEdge* edges = edges_of(node);
+        int parent_visits = node->visit_count.load(std::memory_order_relaxed) +
+                            node->virtual_loss.load(std::memory_order_relaxed);
+        
+        bool winning_child = false;
+        for (int i = 0; i < num_children; ++i) {
+            MCTSNode* child = nodes_.ptr(edges[i].child);
+            // Decided children: a proven win settles this node, proven
+            // losses are never worth a playout
+            ProofState proof = child->proof_state();
+            if (proof == PROVEN_WIN) {
+                winning_child = true;
+                break;
+            }
+            if (proof == PROVEN_LOSS) continue;
+            double uct = puct ? puct_value(child, edges[i], node->q_value(), parent_visits)
+                              : uct_value(child, edges[i], parent_visits);
             if (uct > best_uct) {
                 best_uct = uct;
-                best_child = child.get();
+                best_child = edges[i].child;
+                best_move = edges[i].move;
             }
         }
         
-        if (best_child == nullptr) break;
+        // The winning child may have been proven through another parent of
+        // its transposition, so prove this node here rather than on the way
+        // back up from a leaf below it
+        if (winning_child) {
+            update_proof(node);
+            break;
+        }
         
-        node = best_child;
-        board.make_move(node->move);
+        // With every open child lost, the node is expanded past its widening
+        if (best_child == NO_NODE) break;
+        
+        // PUCT: the best untried edge is the next in prior order; if it
+        // outscores the children, stop here to expand it
+        if (puct && num_children < num_edges &&
+            puct_value(nullptr, edges[num_children], node->q_value(), parent_visits) > best_uct) {
+            break;
+        }
+        
+        node_idx = best_child;
+        node = nodes_.ptr(node_idx);
+        // Discourage other threads from following this thread down the same path
+        node->virtual_loss.fetch_add(config_.virtual_loss, std::memory_order_relaxed);
+        board.make_move(best_move);
+        ctx.path.push_back(node_idx);
     }
     
-    return node;
+    return node_idx;
 }
 
-MCTSNode* MCTS::expand(MCTSNode* node, Board& board) {
-    if (node->untried_moves.empty()) return node;
+NodeIndex MCTS::expand(NodeIndex node_idx, Board& board, SearchContext& ctx) {
+    MCTSNode* node = nodes_.ptr(node_idx);
     
-    // Use heuristic to pick a promising move
-    Move move;
-    if (node->untried_moves.size() > 3) {
-        // Score a few random moves and pick the best
-        std::vector<ScoredMove> candidates;
-        int sample_size = std::min(5, static_cast<int>(node->untried_moves.size()));
-        
-        // Shuffle and take sample
-        std::shuffle(node->untried_moves.begin(), node->untried_moves.end(), rng_);
-        for (int i = 0; i < sample_size; ++i) {
-            candidates.push_back(heuristic_.score_move(board, node->untried_moves[i]));
-        }
-        
-        // Pick highest scored
-        auto best = std::max_element(candidates.begin(), candidates.end(), 
-            [](const ScoredMove& a, const ScoredMove& b) { return a.score < b.score; });
-        
-        // Find and remove from untried
-        auto it = std::find(node->untried_moves.begin(), node->untried_moves.end(), best->move);
-        move = *it;
-        node->untried_moves.erase(it);
-    } else {
-        // Just pick randomly from remaining
-        std::uniform_int_distribution<size_t> dist(0, node->untried_moves.size() - 1);
-        size_t idx = dist(rng_);
-        move = node->untried_moves[idx];
-        node->untried_moves.erase(node->untried_moves.begin() + idx);
+    // Only one thread expands a node at a time; readers never look past
+    // num_expanded, so the untried tail can be reordered under the lock
+    while (node->expanding.exchange(true, std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+    if (node->is_fully_expanded() &&
+        (node->all_moves.load(std::memory_order_relaxed) || !widen(node, board, ctx))) {
+        node->expanding.store(false, std::memory_order_release);
+        return node_idx;
     }
     
-    // Create new node
-    board.make_move(move);
-    auto child = std::make_unique<MCTSNode>(move, node, board.current_player());
+    // Untried moves are the tail [num_expanded, num_edges) of the edge range,
+    // already in heuristic order: the next one is the best of them
+    int expanded = node->expanded_count();
+    MCTSEdge& edge = edges_of(node)[expanded];
     
-    // Check if this move resulted in a terminal state
-    if (board.is_terminal()) {
-        child->is_terminal_node = true;
-        int8_t winner = board.get_winner();
-        if (winner == EMPTY) {
-            child->terminal_value = 0.0; // Draw
+    // Rank the child's moves outside the tree lock; the score cache is
+    // synced here anyway for the rollout that follows
+    board.make_move(edge.move);
+    ScoredMove ordered[BOARD_CELLS];
+    int num_ordered = 0;
+    bool forced = false;
+    if (!board.is_terminal()) {
+        ctx.scores.sync(board);
+        num_ordered = order_moves(ctx.scores, board, ordered, forced);
+    }
+    
+    // Create the child, or link the node already reached by another move order
+    NodeIndex child_idx;
+    {
+        std::lock_guard<std::mutex> lock(tree_mutex_);
+        child_idx = config_.use_transpositions ? table_.find(board.hash()) : NO_NODE;
+        if (child_idx == NO_NODE) {
+            child_idx = create_node(board, ordered, num_ordered, forced);
         } else {
-            // Value from the perspective of the player who just moved (node's player)
-            // node->player_to_move is who made the move to reach this child
-            child->terminal_value = (winner == node->player_to_move) ? 1.0 : -1.0;
+            transpositions_.fetch_add(1, std::memory_order_relaxed);
         }
-    } else {
-        init_untried_moves(child.get(), board);
     }
+    nodes_[child_idx].virtual_loss.fetch_add(config_.virtual_loss, std::memory_order_relaxed);
+    ctx.path.push_back(child_idx);
     
-    MCTSNode* child_ptr = child.get();
-    node->children.push_back(std::move(child));
+    // Publish the fully initialized child
+    edge.child = child_idx;
+    node->num_expanded.store(static_cast<uint16_t>(expanded + 1), std::memory_order_release);
+    node->expanding.store(false, std::memory_order_release);
     
-    return child_ptr;
+    return child_idx;
 }
 
-double MCTS::rollout(Board& board) {
+bool MCTS::widen(MCTSNode* node, Board& board, SearchContext& ctx) {
+    int num_tried = node->edge_count();
+    const MCTSEdge* tried = edges_of(node);
+    BitBoard tried_moves;
+    for (int i = 0; i < num_tried; ++i) {
+        if (nodes_[tried[i].child].proof_state() != PROVEN_LOSS) return false;
+        tried_moves.set(tried[i].move.to_index());
+    }
+    
+    // Every legal move by score in a new range, the tried ones moved to the
+    // front with their children and statistics; the old range stays valid
+    // for threads still reading it
+    ctx.scores.sync(board);
+    ScoredMove ordered[BOARD_CELLS];
+    int num_ordered = ctx.scores.top_moves(board, BOARD_CELLS, ordered);
+    uint32_t first;
+    {
+        std::lock_guard<std::mutex> lock(tree_mutex_);
+        first = edges_.allocate(num_ordered);
+    }
+    MCTSEdge* edges = edges_.ptr(first);
+    init_edges(edges, ordered, num_ordered);
+    std::stable_partition(edges, edges + num_ordered, [&](const MCTSEdge& edge) {
+        return tried_moves[edge.move.to_index()];
+    });
+    for (int i = 0; i < num_tried; ++i) edges[i] = tried[i];
+    
+    // Publish the range before the count, and the count before all_moves
+    node->first_edge.store(first, std::memory_order_release);
+    node->num_edges.store(static_cast<uint16_t>(num_ordered), std::memory_order_release);
+    node->all_moves.store(true, std::memory_order_release);
+    return true;
+}
+
+double MCTS::rollout(Board& board, SearchContext& ctx) {
     if (board.is_terminal()) {
         int8_t winner = board.get_winner();
         if (winner == EMPTY) return 0.0;
-        return (winner == board.current_player()) ? -1.0 : 1.0;
+        return (winner == board.current_player()) ? 1.0 : -1.0;
     }
     
+    // Both rollouts start from this position and unmake their moves
     double total = 0.0;
     int count = 0;
     
     if (config_.use_heuristic_rollouts) {
-        Board board_copy = board;
-        total += heuristic_rollout(board_copy);
+        total += heuristic_rollout(board, ctx);
         ++count;
     }
     
     if (config_.use_random_rollouts) {
-        Board board_copy = board;
-        total += random_rollout(board_copy);
+        total += random_rollout(board, ctx);
         ++count;
     }
     
     return count > 0 ? total / count : 0.0;
 }
 
-double MCTS::heuristic_rollout(Board& board) {
+double MCTS::heuristic_rollout(Board& board, SearchContext& ctx) {
     int8_t start_player = board.current_player();
+    int start_moves = board.move_count();
     int max_moves = 50; // Limit rollout length
     
+    // Scores are patched move by move instead of recomputed every ply
+    ctx.scores.sync(board);
+    ScoredMove top[ROLLOUT_TOP];
+    
     while (!board.is_terminal() && max_moves-- > 0) {
-        auto scored_moves = heuristic_.get_scored_moves(board);
-        if (scored_moves.empty()) break;
+        ThreatSummary threats;
+        int top_n = ctx.scores.top_moves(board, ROLLOUT_TOP, top, &threats);
+        if (top_n == 0) break;
+        
+        // Forced replies are always played: win, block a five, open four
+        Move forced = threats.forced_move(board.current_player());
+        if (forced.is_valid()) {
+            ctx.scores.make_move(board, forced);
+            continue;
+        }
         
         // Pick from top moves with some randomness
-        int top_n = std::min(3, static_cast<int>(scored_moves.size()));
         std::uniform_int_distribution<int> dist(0, top_n - 1);
-        int idx = dist(rng_);
+        int idx = dist(ctx.rng);
         
-        board.make_move(scored_moves[idx].move);
+        ctx.scores.make_move(board, top[idx].move);
     }
     
     int8_t winner = board.get_winner();
-    if (winner == EMPTY) return 0.0;
-    return (winner == start_player) ? 1.0 : -1.0;
+    double value = winner == EMPTY ? 0.0 : (winner == start_player ? 1.0 : -1.0);
+    if (config_.use_rave) record_playout(ctx, board, start_moves, value);
+    ctx.scores.unmake_to(board, start_moves);
+    return value;
 }
 
-double MCTS::random_rollout(Board& board) {
+double MCTS::random_rollout(Board& board, SearchContext& ctx) {
     int8_t start_player = board.current_player();
+    int start_moves = board.move_count();
     int max_moves = 50;
     
+    // Filled afresh each ply (get_legal_moves resets the count); Move is
+    // not trivially constructible, so the array is only set up once
+    MoveList moves;
     while (!board.is_terminal() && max_moves-- > 0) {
-        auto moves = board.get_legal_moves();
+        board.get_legal_moves(moves);
         if (moves.empty()) break;
         
-        std::uniform_int_distribution<size_t> dist(0, moves.size() - 1);
-        board.make_move(moves[dist(rng_)]);
+        std::uniform_int_distribution<int> dist(0, moves.size() - 1);
+        board.make_move(moves[dist(ctx.rng)]);
     }
     
     int8_t winner = board.get_winner();
-    if (winner == EMPTY) return 0.0;
-    return (winner == start_player) ? 1.0 : -1.0;
+    double value = winner == EMPTY ? 0.0 : (winner == start_player ? 1.0 : -1.0);
+    if (config_.use_rave) record_playout(ctx, board, start_moves, value);
+    board.unmake_to(start_moves);
+    return value;
+}
+
+void MCTS::record_playout(SearchContext& ctx, const Board& board, int start_moves,
+                          double value) const {
+    auto& playout = ctx.playouts[ctx.num_playouts++];
+    const auto& history = board.get_history();
+    playout.moves.assign(history.begin() + start_moves, history.end());
+    playout.value = value;
 }
 
-void MCTS::backpropagate(MCTSNode* node, double value, int8_t root_player) {
-    while (node != nullptr) {
-        ++node->visit_count;
+void MCTS::backpropagate(const std::vector<NodeIndex>& path, double value, int8_t root_player) {
+    for (size_t i = 0; i < path.size(); ++i) {
+        MCTSNode* node = nodes_.ptr(path[i]);
         
-        // Value is from perspective of player who just moved
+        // Value is from the root player's perspective
         // We need to flip based on whose turn it is at this node
         double adjusted_value = (node->player_to_move == root_player) ? value : -value;
-        node->total_value += adjusted_value;
+        atomic_add(node->total_value, adjusted_value);
+        node->visit_count.fetch_add(1, std::memory_order_relaxed);
+        
+        // Every node below the root was charged a virtual loss on the way down
+        if (i > 0) {
+            node->virtual_loss.fetch_sub(config_.virtual_loss, std::memory_order_relaxed);
+        }
+    }
+    
+    // Proofs bubble up from the end of the path until a node stays open
+    for (size_t i = path.size(); i-- > 0;) {
+        MCTSNode* node = nodes_.ptr(path[i]);
+        if (node->proof_state() == UNPROVEN && !update_proof(node)) break;
+    }
+}
+
+void MCTS::update_amaf(SearchContext& ctx, int root_moves, double leaf_value) {
+    // Tree move i leads from path[i] to path[i + 1]; every move alternates
+    // the player, so a rollout's even plies belong to the leaf's player
+    const auto& history = ctx.board.get_history();
+    size_t leaf = ctx.path.size() - 1;
+    int8_t leaf_player = nodes_[ctx.path[leaf]].player_to_move;
+    int count = std::max(ctx.num_playouts, 1);
+    for (int r = 0; r < count; ++r) {
+        BitBoard mover, other;  // Cells played by the node's player to move / its opponent
+        double value = leaf_value;
+        if (ctx.num_playouts > 0) {
+            const auto& playout = ctx.playouts[r];
+            for (size_t k = 0; k < playout.moves.size(); ++k) {
+                (k % 2 == 0 ? mover : other).set(playout.moves[k].to_index());
+            }
+            value = playout.value;
+        }
         
-        node = node->parent;
+        for (size_t i = leaf + 1; i-- > 0;) {
+            if (i < leaf) {
+                std::swap(mover, other);
+                mover.set(history[root_moves + i].to_index());
+            }
+            MCTSNode* node = nodes_.ptr(ctx.path[i]);
+            float node_value = static_cast<float>(node->player_to_move == leaf_player ? value : -value);
+            int expanded = node->expanded_count();
+            MCTSEdge* edges = edges_of(node);
+            for (int e = 0; e < expanded; ++e) {
+                if (!mover[edges[e].move.to_index()]) continue;
+                edges[e].amaf_visits.fetch_add(1, std::memory_order_relaxed);
+                atomic_add(edges[e].amaf_total, node_value);
+            }
+        }
     }
 }
 
-double MCTS::uct_value(const MCTSNode* node, int parent_visits) const {
-    if (node->visit_count == 0) {
+bool MCTS::update_proof(MCTSNode* node) {
+    // Children are proven from the perspective of this node's player to move
+    // all_moves is set after a widened edge range is published
+    bool all_moves = node->all_moves.load(std::memory_order_acquire);
+    int expanded = node->expanded_count();
+    bool all_decided = expanded > 0 && expanded == node->edge_count() && all_moves;
+    const MCTSEdge* edges = edges_of(node);
+    bool any_draw = false;
+    for (int i = 0; i < expanded; ++i) {
+        ProofState proof = nodes_[edges[i].child].proof_state();
+        if (proof == PROVEN_WIN) {
+            node->proof.store(PROVEN_LOSS, std::memory_order_release);
+            return true;
+        }
+        if (proof == UNPROVEN) all_decided = false;
+        any_draw |= proof == PROVEN_DRAW;
+    }
+    if (!all_decided) return false;
+    node->proof.store(any_draw ? PROVEN_DRAW : PROVEN_WIN, std::memory_order_release);
+    return true;
+}
+
+int MCTS::children_allowed(const MCTSNode* node) const {
+    if (config_.widening_constant <= 0.0) return node->edge_count();
+    int n = node->visit_count.load(std::memory_order_relaxed);
+    double open = std::ceil(config_.widening_constant * std::pow(std::max(1, n), config_.widening_exponent));
+    return static_cast<int>(std::min<double>(open, node->edge_count()));
+}
+
+double MCTS::child_value(const MCTSNode* node, const MCTSEdge& edge, int n, int pending) const {
+    // Virtual loss: count pending visits as wins for this node's player to
+    // move, i.e. losses from the parent's point of view. Negate because we
+    // want from parent's perspective (opponent's score)
+    double value = -(node->total_value.load(std::memory_order_relaxed) + pending) / n;
+    
+    // RAVE: lean on the AMAF value (already from the parent's perspective)
+    // while the child has few visits of its own
+    int amaf_n = edge.amaf_visits.load(std::memory_order_relaxed);
+    if (config_.use_rave && amaf_n > 0) {
+        double beta;
+        if (config_.rave_schedule == RaveSchedule::EQUIVALENCE) {
+            beta = std::sqrt(config_.rave_equivalence / (3.0 * n + config_.rave_equivalence));
+        } else {
+            double b = config_.rave_bias;
+            beta = amaf_n / (n + amaf_n + 4.0 * b * b * n * amaf_n);
+        }
+        value = (1.0 - beta) * value + beta * edge.amaf_value();
+    }
+    return value;
+}
+
+double MCTS::uct_value(const MCTSNode* node, const MCTSEdge& edge, int parent_visits) const {
+    int pending = node->virtual_loss.load(std::memory_order_relaxed);
+    int n = node->visit_count.load(std::memory_order_relaxed) + pending;
+    if (n == 0) {
         return std::numeric_limits<double>::infinity();
     }
     
-    double exploitation = node->q_value();
     double exploration = config_.exploration_constant * 
-                         std::sqrt(std::log(static_cast<double>(parent_visits)) / node->visit_count);
-    
-    // Negate because we want from parent's perspective (opponent's score)
-    return -exploitation + exploration;
+                         std::sqrt(std::log(static_cast<double>(std::max(1, parent_visits))) / n);
+    return child_value(node, edge, n, pending) + exploration;
 }
 
-Move MCTS::select_best_move(MCTSNode* root, const Board& board) const {
+double MCTS::puct_value(const MCTSNode* node, const MCTSEdge& edge, double fpu,
+                        int parent_visits) const {
+    // Q + c * P * sqrt(N) / (1 + n): unvisited children are not forced
+    // first, they compete through their prior
+    int pending = node ? node->virtual_loss.load(std::memory_order_relaxed) : 0;
+    int n = node ? node->visit_count.load(std::memory_order_relaxed) + pending : 0;
+    double value = n > 0 ? child_value(node, edge, n, pending) : fpu;
+    double exploration = config_.puct_constant * edge.prior *
+                         std::sqrt(static_cast<double>(std::max(1, parent_visits))) / (1 + n);
+    return value + exploration;
+}
+
+Move MCTS::select_best_move(const MCTSNode* root, const Board& board) const {
+    // One sweep finds every forcing move for both sides
+    ThreatSummary threats = heuristic_.classify_threats(board);
+    const auto& own = threats.of(board.current_player());
+    const auto& opponent = threats.of(-board.current_player());
+    
     // Priority 1: Immediate 5-in-a-row win - always take it
-    Move winning = heuristic_.find_winning_move(board);
-    if (winning.is_valid()) {
-        return winning;
+    if (own.five.is_valid()) {
+        return own.five;
     }
     
     // Priority 2: Block opponent's 4-in-a-row - must block or lose next turn
-    Move blocking = heuristic_.find_blocking_move(board);
-    if (blocking.is_valid()) {
-        return blocking;
+    if (opponent.five.is_valid()) {
+        return opponent.five;
     }
     
     // Priority 3: Create open four - guaranteed win (opponent can't block both ends)
-    Move open_four = heuristic_.find_open_four_move(board);
-    if (open_four.is_valid()) {
-        return open_four;
+    if (own.open_four.is_valid()) {
+        return own.open_four;
+    }
+    
+    // A win proven by the search beats any heuristic priority below
+    if (root->edge_count() == 0) {
+        return Move();
+    }
+    const MCTSEdge* root_edges = edges_.ptr(root->first_edge);
+    for (int i = 0; i < root->expanded_count(); ++i) {
+        if (nodes_[root_edges[i].child].proof_state() == PROVEN_WIN) return root_edges[i].move;
     }
     
     // Priority 4: Block opponent's open three - if we don't, they get open four next turn
-    Move open_three_block = heuristic_.find_open_three_block(board);
-    if (open_three_block.is_valid()) {
-        return open_three_block;
+    if (opponent.strongest.is_valid()) {
+        return opponent.strongest;
     }
     
     // Priority 5: Use MCTS result
-    if (root->children.empty()) {
-        // Fallback to untried moves
-        if (!root->untried_moves.empty()) {
-            return root->untried_moves[0];
-        }
+    return most_visited_move(root);
+}
+
+Move MCTS::get_most_visited_move() const {
+    return has_tree() ? most_visited_move(nodes_.ptr(root_)) : Move();
+}
+
+Move MCTS::most_visited_move(const MCTSNode* root) const {
+    if (root->edge_count() == 0) {
         return Move();
     }
+    const MCTSEdge* root_edges = edges_.ptr(root->first_edge);
+    BitBoard proven_lost;
+    for (int i = 0; i < root->expanded_count(); ++i) {
+        if (nodes_[root_edges[i].child].proof_state() == PROVEN_LOSS) {
+            proven_lost.set(root_edges[i].move.to_index());
+        }
+    }
     
-    // Select most visited child
-    MCTSNode* best = nullptr;
-    int best_visits = -1;
+    // Merge root child statistics over our tree and any root-parallel trees
+    RootStats stats;
+    stats.visits.fill(0);
+    stats.total_value.fill(0.0);
+    add_root_stats(stats);
+    for (const auto& worker : root_workers_) {
+        worker->add_root_stats(stats);
+    }
     
-    for (const auto& child : root->children) {
-        if (child->visit_count > best_visits) {
-            best_visits = child->visit_count;
-            best = child.get();
+    // Select most visited move; children values are from the opponent's
+    // perspective, so ties go to the lowest total value. Moves proven lost
+    // only count if nothing else is left.
+    if (static_cast<int>(proven_lost.count()) < root->edge_count()) {
+        proven_lost.for_each([&](int idx) { stats.visits[idx] = 0; });
+    }
+    int best_idx = -1;
+    for (int idx = 0; idx < BOARD_CELLS; ++idx) {
+        if (stats.visits[idx] == 0) continue;
+        if (best_idx < 0 || stats.visits[idx] > stats.visits[best_idx] ||
+            (stats.visits[idx] == stats.visits[best_idx] &&
+             stats.total_value[idx] < stats.total_value[best_idx])) {
+            best_idx = idx;
         }
     }
     
-    return best ? best->move : Move();
+    if (best_idx < 0) {
+        // Fallback to untried moves, or the first move not proven lost
+        for (int i = 0; i < root->edge_count(); ++i) {
+            if (!proven_lost[root_edges[i].move.to_index()]) return root_edges[i].move;
+        }
+        return root_edges[0].move;
+    }
+    return Move(to_x(best_idx), to_y(best_idx));
 }
 
-void MCTS::init_untried_moves(MCTSNode* node, const Board& board) {
-    node->untried_moves = board.get_legal_moves();
+void MCTS::init_untried_moves(MCTSNode* node, const Board& board,
+                              const ScoredMove* ordered, int num_ordered, bool forced) {
+    node->num_edges.store(static_cast<uint16_t>(num_ordered), std::memory_order_relaxed);
+    node->all_moves.store(forced || num_ordered == board.count_legal_moves(), std::memory_order_relaxed);
+    if (num_ordered == 0) return;
+    
+    // Only the candidates get edges, best first
+    uint32_t first = edges_.allocate(num_ordered);
+    init_edges(edges_.ptr(first), ordered, num_ordered);
+    node->first_edge.store(first, std::memory_order_relaxed);
+}
+
+void MCTS::init_edges(MCTSEdge* edges, const ScoredMove* ordered, int num_ordered) const {
+    // Priors from a softmax over the scores (the first score is the highest)
+    double temperature = std::max(1.0, config_.prior_temperature);
+    double sum = 0.0;
+    for (int i = 0; i < num_ordered; ++i) {
+        double weight = std::exp((ordered[i].score - ordered[0].score) / temperature);
+        edges[i].init(ordered[i].move, static_cast<float>(weight));
+        sum += weight;
+    }
+    for (int i = 0; i < num_ordered; ++i) {
+        edges[i].prior = static_cast<float>(edges[i].prior / sum);
+    }
 }
 
 } // namespace gomoku
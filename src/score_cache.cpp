@@ -0,0 +1,184 @@
+#include "score_cache.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
+namespace gomoku {
+
+ScoreCache::ScoreCache() {
+    Board empty;
+    for (int idx = 0; idx < BOARD_CELLS; ++idx) {
+        CellScores& cell = cells_[idx];
+        for (int s = 0; s < 2; ++s) {
+            cell.line[s] = cell.defence[s] = 0;
+            cell.classes[s] = uint8_t(1) << LINE_NONE;
+            for (int dir = 0; dir < 4; ++dir) cell.dir_class[s][dir] = LINE_NONE;
+        }
+        for (int dir = 0; dir < 4; ++dir) rescore_line(empty, idx, dir);
+        
+        // Empty board: the cluster bonus is just the space bonus
+        int neighbours = 0;
+        for (int dx = -2; dx <= 2; dx++) {
+            for (int dy = -2; dy <= 2; dy++) {
+                if ((dx != 0 || dy != 0) && in_bounds(to_x(idx) + dx, to_y(idx) + dy)) {
+                    neighbours++;
+                }
+            }
+        }
+        cells_[idx].cluster[0] = cells_[idx].cluster[1] = neighbours * SCORE_SPACE;
+        rerank(cells_[idx]);
+    }
+    history_.reserve(BOARD_CELLS);
+}
+
+void ScoreCache::sync(const Board& board) {
+    const auto& target = board.get_history();
+    
+    size_t common = 0;
+    while (common < history_.size() && common < target.size() &&
+           history_[common] == target[common]) {
+        common++;
+    }
+    if (common == history_.size() && common == target.size()) return;
+    
+    // Cluster bonuses are sums, so moves can be taken back and replayed in
+    // any order; line scores are re-read from the board's final windows
+    for (size_t k = history_.size(); k-- > common;) {
+        add_cluster(history_[k], k % 2 == 0 ? BLACK : WHITE, -1);
+    }
+    for (size_t k = common; k < target.size(); ++k) {
+        add_cluster(target[k], k % 2 == 0 ? BLACK : WHITE, +1);
+    }
+    for (size_t k = common; k < history_.size(); ++k) {
+        rescore_lines_around(board, history_[k]);
+    }
+    for (size_t k = common; k < target.size(); ++k) {
+        rescore_lines_around(board, target[k]);
+    }
+    
+    history_.assign(target.begin(), target.end());
+}
+
+void ScoreCache::make_move(Board& board, const Move& move) {
+    int8_t player = board.current_player();
+    board.make_move(move);
+    add_cluster(move, player, +1);
+    rescore_lines_around(board, move);
+    history_.push_back(move);
+}
+
+void ScoreCache::unmake_to(Board& board, int move_count) {
+    while (board.move_count() > move_count) {
+        Move move = board.get_history().back();
+        board.unmake_move(move);
+        add_cluster(move, board.current_player(), -1);
+        rescore_lines_around(board, move);
+        history_.pop_back();
+    }
+}
+
+ScoredMove ScoreCache::score_move(const Board& board, const Move& move) const {
+    const CellScores& cell = cells_[move.to_index()];
+    int me = slot(board.current_player());
+    int opp = 1 - me;
+    
+    ScoredMove sm(move, 0);
+    sm.score = cell.line[me] + cell.defence[opp] + cell.cluster[me];
+    sm.is_winning = cell.classes[me] & (1 << LINE_WIN);
+    sm.is_blocking = cell.classes[opp] >= (1 << LINE_FOUR_OPEN);
+    return sm;
+}
+
+int ScoreCache::top_moves(const Board& board, int k, ScoredMove* out,
+                          ThreatSummary* threats) const {
+    // Once k moves are kept, a cell is only scored if its rank beats the
+    // worst of them
+    int me = slot(board.current_player());
+    TopMoves top(out, k);
+    int64_t bar = std::numeric_limits<int64_t>::min();
+    board.for_each_legal_index([&](int idx) {
+        const CellScores& cell = cells_[idx];
+        Move move(to_x(idx), to_y(idx));
+        if (threats) threats->add(move, cell.classes[0], cell.classes[1]);
+        if (cell.rank[me] <= bar) return;
+        top.offer(score_move(board, move));
+        if (top.full()) bar = cells_[top.worst().move.to_index()].rank[me];
+    });
+    return top.finish();
+}
+
+ThreatSummary ScoreCache::classify_threats(const Board& board) const {
+    ThreatSummary threats;
+    board.for_each_legal_move([&](const Move& move) {
+        const CellScores& cell = cells_[move.to_index()];
+        threats.add(move, cell.classes[0], cell.classes[1]);
+    });
+    return threats;
+}
+
+void ScoreCache::rescore_line(const Board& board, int idx, int dir) {
+    CellScores& cell = cells_[idx];
+    int code = board.window_code(idx, dir);
+    bool changed = false;
+    for (int s = 0; s < 2; ++s) {
+        LineClass cls = Heuristic::line_class(code, s == 0 ? BLACK : WHITE);
+        uint8_t* dir_class = cell.dir_class[s];
+        if (cls == dir_class[dir]) continue;
+        cell.line[s] += LINE_CLASS_SCORE[cls] - LINE_CLASS_SCORE[dir_class[dir]];
+        cell.defence[s] = static_cast<int>(cell.line[s] * 1.1);
+        dir_class[dir] = cls;
+        changed = true;
+        cell.classes[s] = static_cast<uint8_t>((1 << dir_class[0]) | (1 << dir_class[1]) |
+                                               (1 << dir_class[2]) | (1 << dir_class[3]));
+    }
+    if (changed) rerank(cell);
+}
+
+void ScoreCache::rerank(CellScores& cell) {
+    for (int me = 0; me < 2; ++me) {
+        int opp = 1 - me;
+        cell.rank[me] = rank(cell.classes[me] & (1 << LINE_WIN),
+                             cell.classes[opp] >= (1 << LINE_FOUR_OPEN),
+                             cell.line[me] + cell.defence[opp] + cell.cluster[me]);
+    }
+}
+
+void ScoreCache::rescore_lines_around(const Board& board, const Move& move) {
+    // Only the window along the direction to the stone changes. Occupied
+    // cells are left stale and caught up when their stone is taken back,
+    // which is the one time the move's own cell is empty here.
+    for (int dir = 0; dir < 4; ++dir) {
+        const auto& [dx, dy] = DIRECTIONS[dir];
+        for (int i = -PATTERN_REACH; i <= PATTERN_REACH; ++i) {
+            int nx = move.x + dx * i;
+            int ny = move.y + dy * i;
+            if (in_bounds(nx, ny) && board.get(nx, ny) == EMPTY) {
+                rescore_line(board, to_index(nx, ny), dir);
+            }
+        }
+    }
+}
+
+void ScoreCache::add_cluster(const Move& move, int8_t player, int sign) {
+    // A stone in the 5x5 neighbourhood removes one empty square (space bonus)
+    // for both colours and adds a distance-weighted cluster bonus for its own
+    int own = slot(player);
+    for (int dx = -2; dx <= 2; dx++) {
+        for (int dy = -2; dy <= 2; dy++) {
+            int nx = move.x + dx;
+            int ny = move.y + dy;
+            if ((dx == 0 && dy == 0) || !in_bounds(nx, ny)) continue;
+            int dist = std::max(std::abs(dx), std::abs(dy));
+            CellScores& cell = cells_[to_index(nx, ny)];
+            int own_delta = sign * (SCORE_CLUSTER * (3 - dist) - SCORE_SPACE);
+            int other_delta = -sign * SCORE_SPACE;
+            cell.cluster[own] += own_delta;
+            cell.cluster[1 - own] += other_delta;
+            // The score is the low field of the rank, so it moves the same
+            cell.rank[own] += own_delta;
+            cell.rank[1 - own] += other_delta;
+        }
+    }
+}
+
+} // namespace gomoku
@@ -0,0 +1,27 @@
+#include "threat_space.hpp"
+#include "heuristic.hpp"
+
+namespace gomoku {
+
+int threat_replies(const Board& board, BitBoard& replies) {
+    int8_t defender = board.current_player();
+    int cells[Heuristic::MAX_FIVE_CELLS];
+    int threats = 0;
+    bool refuted = false;
+    board.for_each_legal_move([&](const Move& m) {
+        if (refuted) return;
+        int idx = m.to_index();
+        int n = Heuristic::five_cells(board, idx, -defender, cells);
+        if (n >= 2) {
+            ++threats;
+            replies.set(idx);
+            for (int i = 0; i < n; ++i) replies.set(cells[i]);
+        }
+        int own = Heuristic::five_cells(board, idx, defender, cells);
+        if (own >= 2) refuted = true;
+        else if (own == 1) replies.set(idx);
+    });
+    return refuted ? -1 : threats;
+}
+
+} // namespace gomoku
@@ -0,0 +1,55 @@
+#include "time_manager.hpp"
+#include <algorithm>
+
+namespace gomoku {
+
+namespace {
+
+// Games rarely go past this many stones; the last own moves keep a floor
+constexpr int EXPECTED_GAME_PLIES = 70;
+constexpr int MIN_MOVES_LEFT = 8;
+
+// Opening moves have little to search, middlegame moves decide the game
+constexpr int OPENING_PLIES = 6;
+constexpr int MIDDLEGAME_PLIES = 40;
+constexpr double OPENING_FACTOR = 0.6;
+constexpr double MIDDLEGAME_FACTOR = 1.3;
+
+// An unstable move may take this many times its target, but never more
+// than this share of the clock (or most of it before a time control)
+constexpr double MAX_EXTENSION = 3.0;
+constexpr double MAX_SHARE = 0.4;
+constexpr double LAST_MOVE_SHARE = 0.9;
+
+constexpr int MIN_MOVE_MS = 1;
+
+} // namespace
+
+TimeManager::TimeManager(int overhead_ms) : overhead_ms_(std::max(0, overhead_ms)) {}
+
+TimeBudget TimeManager::allocate(const TimeControl& control, int move_count) const {
+    int available = std::max(0, control.time_ms - overhead_ms_);
+    int moves_left = control.moves_to_go > 0 ? control.moves_to_go : expected_moves_left(move_count);
+
+    double target = (double(available) / moves_left + control.increment_ms) * phase_factor(move_count);
+    double cap = available * (moves_left <= 1 ? LAST_MOVE_SHARE : MAX_SHARE);
+    double maximum = std::min(target * MAX_EXTENSION, cap);
+    target = std::min(target, maximum);
+
+    TimeBudget budget;
+    budget.target_ms = std::max(MIN_MOVE_MS, static_cast<int>(target));
+    budget.max_ms = std::max(budget.target_ms, static_cast<int>(maximum));
+    return budget;
+}
+
+int TimeManager::expected_moves_left(int move_count) {
+    return std::max(MIN_MOVES_LEFT, (EXPECTED_GAME_PLIES - move_count) / 2);
+}
+
+double TimeManager::phase_factor(int move_count) {
+    if (move_count < OPENING_PLIES) return OPENING_FACTOR;
+    if (move_count < MIDDLEGAME_PLIES) return MIDDLEGAME_FACTOR;
+    return 1.0;
+}
+
+} // namespace gomoku
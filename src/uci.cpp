@@ -35,6 +35,8 @@ std::string UCIEngine::process_command(const std::string& input) {
         return cmd_uci();
     } else if (cmd == "isready") {
         return cmd_isready();
+    } else if (cmd == "setoption") {
+        return cmd_setoption(iss);
     } else if (cmd == "position") {
         return cmd_position(iss);
     } else if (cmd == "go") {
@@ -47,8 +49,11 @@ std::string UCIEngine::process_command(const std::string& input) {
         return cmd_display();
     } else if (cmd == "perft") {
         return cmd_perft(iss);
+    } else if (cmd == "solve") {
+        return cmd_solve(iss);
     } else if (cmd == "ucinewgame") {
         board_.reset();
+        mcts_.clear_tree();
         return "";
     }
     
@@ -60,13 +65,58 @@ void UCIEngine::set_output_handler(std::function<void(const std::string&)> handl
 }
 
 std::string UCIEngine::cmd_uci() {
-    return "id name Gomoku MCTS\nid author DeepReaL\nuciok";
+    return "id name Gomoku MCTS\nid author DeepReaL\n"
+           "option name Threads type spin default 1 min 1 max 256\n"
+           "option name ParallelMode type combo default Tree var Tree var Root\n"
+           "option name Selection type combo default UCT var UCT var PUCT\n"
+           "uciok";
 }
 
 std::string UCIEngine::cmd_isready() {
     return "readyok";
 }
 
+std::string UCIEngine::cmd_setoption(std::istringstream& args) {
+    // Format: setoption name <id> value <x>
+    std::string token, name, value;
+    args >> token;
+    if (token != "name") return "";
+    while (args >> token && token != "value") {
+        name += (name.empty() ? "" : " ") + token;
+    }
+    args >> value;
+    std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+    
+    if (name == "threads") {
+        try {
+            mcts_.config().num_threads = std::clamp(std::stoi(value), 1, 256);
+        } catch (...) {
+            return "info string invalid value for Threads: " + value;
+        }
+    } else if (name == "parallelmode") {
+        std::transform(value.begin(), value.end(), value.begin(), ::tolower);
+        if (value == "tree") {
+            mcts_.config().parallel_mode = ParallelMode::TREE;
+        } else if (value == "root") {
+            mcts_.config().parallel_mode = ParallelMode::ROOT;
+        } else {
+            return "info string invalid value for ParallelMode: " + value;
+        }
+    } else if (name == "selection") {
+        std::transform(value.begin(), value.end(), value.begin(), ::tolower);
+        if (value == "uct") {
+            mcts_.config().selection = SelectionRule::UCT;
+        } else if (value == "puct") {
+            mcts_.config().selection = SelectionRule::PUCT;
+        } else {
+            return "info string invalid value for Selection: " + value;
+        }
+    } else {
+        return "info string unknown option: " + name;
+    }
+    return "";
+}
+
 std::string UCIEngine::cmd_position(std::istringstream& args) {
     std::string token;
     args >> token;
@@ -96,11 +146,27 @@ std::string UCIEngine::cmd_position(std::istringstream& args) {
 
 std::string UCIEngine::cmd_go(std::istringstream& args) {
     int time_ms = 1000; // Default
+    bool fixed_time = false;
+    
+    // Clocks are named by colour: btime/binc for BLACK (who moves first),
+    // wtime/winc for WHITE
+    TimeControl clocks[2];
+    bool has_clock[2] = {false, false};
+    int moves_to_go = 0;
     
     std::string token;
     while (args >> token) {
         if (token == "movetime") {
             args >> time_ms;
+            fixed_time = true;
+        } else if (token == "btime" || token == "wtime") {
+            int side = token[0] == 'b' ? 0 : 1;
+            args >> clocks[side].time_ms;
+            has_clock[side] = true;
+        } else if (token == "binc" || token == "winc") {
+            args >> clocks[token[0] == 'b' ? 0 : 1].increment_ms;
+        } else if (token == "movestogo") {
+            args >> moves_to_go;
         } else if (token == "depth") {
             int depth;
             args >> depth;
@@ -112,8 +178,31 @@ std::string UCIEngine::cmd_go(std::istringstream& args) {
         }
     }
     
+    int side = board_.current_player() == BLACK ? 0 : 1;
+    if (!fixed_time && has_clock[side]) {
+        clocks[side].moves_to_go = moves_to_go;
+        TimeBudget budget = time_manager_.allocate(clocks[side], board_.move_count());
+        Move best = mcts_.search(board_, budget.target_ms, budget.max_ms);
+        return report_move(best);
+    }
+    
     Move best = mcts_.search(board_, time_ms);
-    return "bestmove " + move_to_string(best);
+    return report_move(best);
+}
+
+std::string UCIEngine::report_move(const Move& move) {
+    const char* reason = nullptr;
+    switch (mcts_.get_answer()) {
+        case SearchAnswer::ONLY_MOVE: reason = "only move"; break;
+        case SearchAnswer::FORCED: reason = "forced move"; break;
+        case SearchAnswer::VCF: reason = "vcf win"; break;
+        case SearchAnswer::VCT: reason = "vct win"; break;
+        default: break;
+    }
+    if (reason) {
+        output(std::string("info string ") + reason + " " + move_to_string(move));
+    }
+    return "bestmove " + move_to_string(move);
 }
 
 std::string UCIEngine::cmd_stop() {
@@ -167,6 +256,46 @@ std::string UCIEngine::cmd_perft(std::istringstream& args) {
     return "perft " + std::to_string(depth) + ": " + std::to_string(nodes);
 }
 
+std::string UCIEngine::cmd_solve(std::istringstream& args) {
+    // solve [nodes <n>] [movetime <ms>]: df-pn proof of a threat-space win
+    // for the side to move
+    uint64_t nodes = 10000000;
+    int time_ms = 10000;
+    std::string token;
+    while (args >> token) {
+        if (token == "nodes") {
+            args >> nodes;
+        } else if (token == "movetime") {
+            args >> time_ms;
+        }
+    }
+    
+    // The solver's table is only allocated for engines that use it
+    if (!solver_) solver_ = std::make_unique<DFPNSolver>();
+    Board b = board_;
+    DFPNResult result = solver_->solve(b, nodes, time_ms);
+    
+    std::string out = "result ";
+    switch (result.outcome) {
+        case DFPNResult::PROVEN: out += "proven"; break;
+        case DFPNResult::DISPROVEN: out += "disproven"; break;
+        default: out += "unknown"; break;
+    }
+    if (result.outcome == DFPNResult::PROVEN) {
+        out += " bestmove " + move_to_string(result.best);
+        out += " proofsize " + std::to_string(result.proof_size);
+    }
+    out += " nodes " + std::to_string(result.nodes);
+    out += " nps " + std::to_string(static_cast<uint64_t>(
+        result.seconds > 0 ? result.nodes / result.seconds : 0));
+    out += " time " + std::to_string(static_cast<int>(result.seconds * 1000));
+    if (!result.line.empty()) {
+        out += " pv";
+        for (const auto& m : result.line) out += " " + move_to_string(m);
+    }
+    return out;
+}
+
 Move UCIEngine::parse_move(const std::string& move_str) const {
     if (move_str.length() < 2) return Move();
     
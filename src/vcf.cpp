@@ -0,0 +1,98 @@
+#include "vcf.hpp"
+
+namespace gomoku {
+
+VCFSolver::VCFSolver(uint64_t node_budget)
+    : budget_(node_budget), nodes_(0), exhausted_(false) {
+    line_.reserve(BOARD_CELLS);
+}
+
+VCFResult VCFSolver::solve(Board& board) {
+    VCFResult result;
+    if (board.is_terminal()) return result;
+
+    nodes_ = 0;
+    exhausted_ = false;
+    refuted_.clear();
+    line_.clear();
+
+    int8_t attacker = board.current_player();
+    ThreatSummary threats = heuristic_.classify_threats(board);
+    const auto& defender = threats.of(-attacker);
+    if (threats.of(attacker).five.is_valid()) {
+        line_.push_back(threats.of(attacker).five);
+        result.proven = true;
+    } else if (defender.num_fives <= 1) {
+        // A single defender five must be blocked first; two cannot be
+        int must = defender.num_fives == 1 ? defender.five.to_index() : -1;
+        result.proven = attack(board, must);
+    }
+
+    if (result.proven) result.line = line_;
+    result.nodes = nodes_;
+    result.budget_exhausted = !result.proven && exhausted_;
+    return result;
+}
+
+bool VCFSolver::attack(Board& board, int must) {
+    if (++nodes_ > budget_) {
+        exhausted_ = true;
+        return false;
+    }
+    uint64_t key = board.hash();
+    if (refuted_.find(key) != NodeTable::NOT_FOUND) return false;
+
+    int8_t attacker = board.current_player();
+    int cells[Heuristic::MAX_FIVE_CELLS];
+
+    // Collect the fours (move, the defender's only reply); a move leaving
+    // two fives wins at once, so look for one before recursing
+    struct Four { int move; int reply; };
+    Four fours[BOARD_CELLS];
+    int num_fours = 0;
+    int winning = -1;
+    auto consider = [&](int idx) {
+        int n = Heuristic::five_cells(board, idx, attacker, cells);
+        if (n >= 2) winning = idx;
+        else if (n == 1) fours[num_fours++] = {idx, cells[0]};
+    };
+    if (must >= 0) {
+        consider(must);
+    } else {
+        board.for_each_legal_move([&](const Move& m) {
+            if (winning < 0) consider(m.to_index());
+        });
+    }
+    if (winning >= 0) {
+        line_.push_back(Move(to_x(winning), to_y(winning)));
+        return true;
+    }
+
+    int start = board.move_count();
+    for (int i = 0; i < num_fours; ++i) {
+        Move move(to_x(fours[i].move), to_y(fours[i].move));
+        Move reply(to_x(fours[i].reply), to_y(fours[i].reply));
+        board.make_move(move);
+        board.make_move(reply);
+
+        // The block may give the defender fives: one must be answered next,
+        // two lose the attack
+        int n = Heuristic::five_cells(board, fours[i].reply, -attacker, cells);
+        bool won = false;
+        if (n < 2) {
+            line_.push_back(move);
+            line_.push_back(reply);
+            won = attack(board, n == 1 ? cells[0] : -1);
+            if (!won) line_.resize(line_.size() - 2);
+        }
+        board.unmake_to(start);
+
+        if (won) return true;
+        if (exhausted_) return false;
+    }
+
+    refuted_.insert(key, 0);
+    return false;
+}
+
+} // namespace gomoku
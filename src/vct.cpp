@@ -0,0 +1,199 @@
+#include "vct.hpp"
+#include "threat_space.hpp"
+#include <cstdlib>
+
+namespace gomoku {
+
+namespace {
+
+// Keys of refuted positions also depend on the search state around them
+constexpr uint64_t DEFEND_SALT = 0x9E3779B97F4A7C15ULL;
+
+uint64_t node_key(uint64_t hash, int last, int depth) {
+    return hash ^ (uint64_t(depth) << 56) ^ (uint64_t(last + 1) << 40);
+}
+
+// Same line through both cells, at most PATTERN_REACH apart
+bool shares_line(int a, int b) {
+    int dx = std::abs(to_x(a) - to_x(b));
+    int dy = std::abs(to_y(a) - to_y(b));
+    return (dx == 0 || dy == 0 || dx == dy) && dx <= PATTERN_REACH && dy <= PATTERN_REACH;
+}
+
+Move to_move(int idx) { return Move(to_x(idx), to_y(idx)); }
+
+} // namespace
+
+VCTSolver::VCTSolver(uint64_t node_budget, int time_limit_ms, int max_depth)
+    : budget_(node_budget), time_limit_ms_(time_limit_ms), max_depth_(max_depth),
+      nodes_(0), cut_(false) {
+    line_.reserve(BOARD_CELLS);
+}
+
+VCTResult VCTSolver::solve(Board& board) {
+    VCTResult result;
+    if (board.is_terminal()) return result;
+
+    nodes_ = 0;
+    cut_ = false;
+    deadline_ = std::chrono::steady_clock::now() + std::chrono::milliseconds(time_limit_ms_);
+    refuted_.clear();
+    line_.clear();
+
+    int8_t attacker = board.current_player();
+    ThreatSummary threats = heuristic_.classify_threats(board);
+    const auto& defender = threats.of(-attacker);
+    if (threats.of(attacker).five.is_valid()) {
+        line_.push_back(threats.of(attacker).five);
+        result.proven = true;
+    } else if (defender.num_fives <= 1) {
+        // Iterative deepening: short proofs are found first and cheaply
+        int must = defender.num_fives == 1 ? defender.five.to_index() : -1;
+        for (int depth = 1; depth <= max_depth_ && !result.proven && !cut_; ++depth) {
+            result.proven = attack(board, must, -1, depth);
+        }
+    }
+
+    if (result.proven) result.line = line_;
+    result.nodes = nodes_;
+    result.limit_reached = !result.proven && cut_;
+    return result;
+}
+
+bool VCTSolver::out_of_budget() {
+    if (cut_) return true;
+    ++nodes_;
+    if (nodes_ > budget_ ||
+        (time_limit_ms_ > 0 && nodes_ % TIME_CHECK_INTERVAL == 0 &&
+         std::chrono::steady_clock::now() >= deadline_)) {
+        cut_ = true;
+    }
+    return cut_;
+}
+
+bool VCTSolver::has_double_five(const Board& board, int idx, bool full) const {
+    int8_t attacker = -board.current_player();
+    int cells[Heuristic::MAX_FIVE_CELLS];
+    if (full) {
+        bool found = false;
+        board.for_each_legal_move([&](const Move& m) {
+            if (!found) found = Heuristic::five_cells(board, m.to_index(), attacker, cells) >= 2;
+        });
+        return found;
+    }
+    return Heuristic::new_double_five(board, idx, attacker);
+}
+
+bool VCTSolver::attack(Board& board, int must, int last, int depth) {
+    if (depth <= 0 || out_of_budget()) return false;
+    uint64_t key = node_key(board.hash(), last, depth);
+    if (refuted_.find(key) != NodeTable::NOT_FOUND) return false;
+
+    int8_t attacker = board.current_player();
+    int cells[Heuristic::MAX_FIVE_CELLS];
+
+    // Fours with the defender's only reply, and three candidates: cells
+    // with two more attacker stones on one of their lines
+    struct Four { int move; int reply; };
+    Four fours[BOARD_CELLS];
+    int threes[BOARD_CELLS];
+    int num_fours = 0, num_threes = 0;
+    int winning = -1;
+    auto consider = [&](int idx) {
+        int n = Heuristic::five_cells(board, idx, attacker, cells);
+        if (n >= 2) {
+            winning = idx;
+        } else if (n == 1) {
+            fours[num_fours++] = {idx, cells[0]};
+        } else if (depth >= 2 && (must >= 0 || last < 0 || shares_line(idx, last))) {
+            for (int dir = 0; dir < 4; ++dir) {
+                if (Heuristic::count_stones(board.window_code(idx, dir), attacker) >= 2) {
+                    threes[num_threes++] = idx;
+                    break;
+                }
+            }
+        }
+    };
+    if (must >= 0) {
+        consider(must);
+    } else {
+        board.for_each_legal_move([&](const Move& m) {
+            if (winning < 0) consider(m.to_index());
+        });
+    }
+    if (winning >= 0) {
+        line_.push_back(to_move(winning));
+        return true;
+    }
+
+    int start = board.move_count();
+    size_t mark = line_.size();
+    for (int i = 0; i < num_fours; ++i) {
+        board.make_move(to_move(fours[i].move));
+        board.make_move(to_move(fours[i].reply));
+        int n = Heuristic::five_cells(board, fours[i].reply, -attacker, cells);
+        bool won = false;
+        if (n < 2) {
+            line_.push_back(to_move(fours[i].move));
+            line_.push_back(to_move(fours[i].reply));
+            won = attack(board, n == 1 ? cells[0] : -1, fours[i].move, depth - 1);
+        }
+        board.unmake_to(start);
+        if (won) return true;
+        line_.resize(mark);
+        if (cut_) return false;
+    }
+
+    for (int i = 0; i < num_threes; ++i) {
+        board.make_move(to_move(threes[i]));
+        bool won = false;
+        if (has_double_five(board, threes[i], must >= 0)) {
+            line_.push_back(to_move(threes[i]));
+            won = defend(board, threes[i], depth - 1);
+        }
+        board.unmake_to(start);
+        if (won) return true;
+        line_.resize(mark);
+        if (cut_) return false;
+    }
+
+    refuted_.insert(key, 0);
+    return false;
+}
+
+bool VCTSolver::defend(Board& board, int last, int depth) {
+    if (out_of_budget()) return false;
+    uint64_t key = node_key(board.hash(), last, depth) ^ DEFEND_SALT;
+    if (refuted_.find(key) != NodeTable::NOT_FOUND) return false;
+
+    int8_t defender = board.current_player();
+    int cells[Heuristic::MAX_FIVE_CELLS];
+
+    BitBoard replies;
+    if (threat_replies(board, replies) < 0) {
+        refuted_.insert(key, 0);
+        return false;
+    }
+
+    int start = board.move_count();
+    size_t mark = line_.size();
+    bool held = false;
+    replies.for_each([&](int idx) {
+        if (held || cut_) return;
+        // The proof line follows the last reply tried
+        line_.resize(mark);
+        board.make_move(to_move(idx));
+        int n = Heuristic::five_cells(board, idx, defender, cells);
+        line_.push_back(to_move(idx));
+        held = !attack(board, n == 1 ? cells[0] : -1, last, depth);
+        board.unmake_to(start);
+    });
+    if (held || cut_) {
+        line_.resize(mark);
+        if (held) refuted_.insert(key, 0);
+        return false;
+    }
+    return true;
+}
+
+} // namespace gomoku
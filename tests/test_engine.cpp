@@ -1,9 +1,19 @@
 #include "board.hpp"
 #include "heuristic.hpp"
 #include "mcts.hpp"
+#include "arena.hpp"
+#include "score_cache.hpp"
+#include "vcf.hpp"
+#include "vct.hpp"
+#include "dfpn.hpp"
+#include "uci.hpp"
+#include "time_manager.hpp"
 #include <iostream>
 #include <cassert>
 #include <chrono>
+#include <random>
+#include <cstdlib>
+#include <thread>
 
 using namespace gomoku;
 
@@ -22,6 +32,19 @@ using namespace gomoku;
     } \
 } while(0)
 
+// Deterministic random game of the given length that is still ongoing
+static Board midgame_position(int moves, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    for (;;) {
+        Board board;
+        while (board.move_count() < moves && !board.is_terminal()) {
+            auto legal = board.get_legal_moves();
+            board.make_move(legal[rng() % legal.size()]);
+        }
+        if (!board.is_terminal()) return board;
+    }
+}
+
 // ============================================================================
 // Board Logic Tests
 // ============================================================================
@@ -131,6 +154,7 @@ TEST(unmake_move) {
     
     board.make_move(7, 7);
     board.make_move(8, 7);
+    auto legal_before = board.get_legal_moves();
     board.make_move(7, 8);
     
     ASSERT(board.get(7, 7) == BLACK);
@@ -143,6 +167,155 @@ TEST(unmake_move) {
     ASSERT(board.get(7, 8) == EMPTY);
     ASSERT(board.current_player() == BLACK);
     ASSERT(board.move_count() == 2);
+    ASSERT(board.get_legal_moves() == legal_before);
+}
+
+// Reference five-in-a-row test: walk every ray cell by cell
+static bool scan_makes_five(const Board& board, const Move& move, int8_t player) {
+    for (const auto& [dx, dy] : DIRECTIONS) {
+        int count = 1;
+        for (int sign : {1, -1}) {
+            int nx = move.x + sign * dx, ny = move.y + sign * dy;
+            while (in_bounds(nx, ny) && board.get(nx, ny) == player) {
+                ++count;
+                nx += sign * dx;
+                ny += sign * dy;
+            }
+        }
+        if (count >= 5) return true;
+    }
+    return false;
+}
+
+TEST(line_mask_win_detection) {
+    // Edge runs must not bleed across lines or wrap
+    Board board;
+    for (int y = 10; y < 15; ++y) {
+        board.make_move(14, y);        // Black down the last column
+        if (y < 14) board.make_move(0, y - 10);
+    }
+    ASSERT(board.is_terminal());
+    ASSERT(board.get_winner() == BLACK);
+    
+    // Random games: every ply agrees with the reference scan, for both players
+    std::mt19937_64 rng(3);
+    for (int game = 0; game < 200; ++game) {
+        Board b;
+        while (!b.is_terminal()) {
+            auto legal = b.get_legal_moves();
+            for (const auto& m : legal) {
+                ASSERT(b.makes_five(m, BLACK) == scan_makes_five(b, m, BLACK));
+                ASSERT(b.makes_five(m, WHITE) == scan_makes_five(b, m, WHITE));
+            }
+            Move m = legal[rng() % legal.size()];
+            bool expect_win = scan_makes_five(b, m, b.current_player());
+            b.make_move(m);
+            ASSERT(b.is_terminal() == (expect_win || b.count_legal_moves() == 0));
+        }
+        // Line masks are restored by unmake
+        Move last = b.get_history().back();
+        int8_t winner = b.get_winner();
+        b.unmake_move(last);
+        if (winner != EMPTY) ASSERT(b.makes_five(last, winner));
+        ASSERT(!b.is_terminal());
+    }
+}
+
+TEST(bitboard_ops) {
+    // Dilation matches a per-cell Chebyshev distance check, including at
+    // the edges where shifted stones must not wrap into the next row
+    for (int idx : {0, 14, 16, 112, 210, 224, to_index(13, 1), to_index(1, 13)}) {
+        BitBoard near = BitBoard::single(idx).dilate(LEGAL_RADIUS);
+        int expected = 0;
+        for (int cell = 0; cell < BOARD_CELLS; ++cell) {
+            int dist = std::max(std::abs(to_x(cell) - to_x(idx)), std::abs(to_y(cell) - to_y(idx)));
+            ASSERT(near[cell] == (dist <= LEGAL_RADIUS));
+            expected += dist <= LEGAL_RADIUS;
+        }
+        ASSERT(near.count() == expected);
+    }
+    
+    // Iteration visits set cells in index order; complement stays on the board
+    BitBoard bb;
+    bb.set(3); bb.set(64); bb.set(200);
+    std::vector<int> cells;
+    bb.for_each([&](int idx) { cells.push_back(idx); });
+    ASSERT((cells == std::vector<int>{3, 64, 200}));
+    ASSERT((~bb).count() == BOARD_CELLS - 3);
+    ASSERT((~BitBoard()).count() == BOARD_CELLS);
+    
+    // Raw shifts by zero and by whole words (64 bits = 4 padded rows)
+    ASSERT(bb.shl(0) == bb && bb.shr(0) == bb);
+    BitBoard top = BitBoard::single(to_index(5, 2));
+    BitBoard down = BitBoard::single(to_index(5, 6));
+    ASSERT(top.shl(64) == down && down.shr(64) == top);
+    ASSERT(top.shl(BitBoard::STRIDE * 4 + 1) == BitBoard::single(to_index(6, 6)));
+    ASSERT(top.shl(192).shr(192) == top);
+}
+
+TEST(zobrist_incremental) {
+    std::mt19937_64 rng(7);
+    
+    for (int game = 0; game < 50; ++game) {
+        Board board;
+        ASSERT(board.hash() == board.compute_hash());
+        
+        std::vector<uint64_t> keys;
+        while (!board.is_terminal()) {
+            auto moves = board.get_legal_moves();
+            keys.push_back(board.hash());
+            board.make_move(moves[rng() % moves.size()]);
+            ASSERT(board.hash() == board.compute_hash());
+        }
+        
+        // Unmaking restores every earlier key
+        auto history = board.get_history();
+        for (size_t i = history.size(); i-- > 0;) {
+            board.unmake_move(history[i]);
+            ASSERT(board.hash() == keys[i]);
+            ASSERT(board.hash() == board.compute_hash());
+        }
+    }
+    
+    // Transpositions share a key, side to move is part of it
+    Board a, b;
+    a.make_move(7, 7); a.make_move(8, 8); a.make_move(6, 6);
+    b.make_move(6, 6); b.make_move(8, 8); b.make_move(7, 7);
+    ASSERT(a.hash() == b.hash());
+    a.unmake_move(Move(6, 6));
+    ASSERT(a.hash() != b.hash());
+}
+
+static bool windows_match(const Board& board) {
+    for (int idx = 0; idx < BOARD_CELLS; ++idx) {
+        for (int dir = 0; dir < 4; ++dir) {
+            if (board.window_code(idx, dir) != board.compute_window_code(idx, dir)) return false;
+        }
+    }
+    return true;
+}
+
+TEST(window_codes_incremental) {
+    std::mt19937_64 rng(9);
+    
+    // Corner cell: everything to the left and above is wall
+    Board empty;
+    ASSERT(windows_match(empty));
+    ASSERT((empty.window_code(0, 0) & 0xFF) == 0xFF);
+    ASSERT((empty.window_code(0, 0) >> 8) == 0);
+    
+    for (int game = 0; game < 30; ++game) {
+        Board board;
+        while (!board.is_terminal()) {
+            auto moves = board.get_legal_moves();
+            board.make_move(moves[rng() % moves.size()]);
+            ASSERT(windows_match(board));
+        }
+        board.unmake_to(board.move_count() / 2);
+        ASSERT(windows_match(board));
+        board.unmake_to(0);
+        ASSERT(windows_match(board));
+    }
 }
 
 // ============================================================================
@@ -211,6 +384,477 @@ TEST(winning_move_detection) {
     ASSERT((winning.x == 4 && winning.y == 7) || (winning.x == 9 && winning.y == 7));
 }
 
+TEST(pattern_table_edges) {
+    Heuristic heuristic;
+    
+    // BLACK three in the open: extending it makes an open four
+    Board open;
+    open.make_move(5, 7);  open.make_move(14, 0);
+    open.make_move(6, 7);  open.make_move(14, 2);
+    open.make_move(7, 7);  open.make_move(14, 4);
+    ASSERT(heuristic.evaluate_move(open, Move(8, 7)) >= SCORE_FOUR_OPEN);
+    
+    // Same three against the left edge: the board boundary closes the four
+    Board edge;
+    edge.make_move(0, 7);  edge.make_move(14, 0);
+    edge.make_move(1, 7);  edge.make_move(14, 2);
+    edge.make_move(2, 7);  edge.make_move(14, 4);
+    int closed = heuristic.evaluate_move(edge, Move(3, 7));
+    ASSERT(closed >= SCORE_FOUR_CLOSED && closed < SCORE_FOUR_OPEN);
+    
+    // Gapped four reaching the window end still wins (X X X _ X)
+    Board gapped;
+    gapped.make_move(3, 3);  gapped.make_move(14, 0);
+    gapped.make_move(4, 4);  gapped.make_move(14, 2);
+    gapped.make_move(5, 5);  gapped.make_move(14, 4);
+    gapped.make_move(7, 7);  gapped.make_move(14, 6);
+    ScoredMove sm = heuristic.score_move(gapped, Move(6, 6));
+    ASSERT(sm.is_winning);
+    
+    // The defender sees the same window from the other colour
+    gapped.make_move(0, 14);
+    ASSERT(heuristic.score_move(gapped, Move(6, 6)).is_blocking);
+}
+
+TEST(four_gains_exact) {
+    // The gains mask of a move names exactly the cells where its player
+    // then completes five, broken fours included
+    std::mt19937_64 rng(23);
+    for (int game = 0; game < 40; ++game) {
+        Board board = midgame_position(10 + game, rng());
+        int8_t player = board.current_player();
+        BitBoard existing;  // Fives the player already has
+        board.for_each_legal_move([&](const Move& g) {
+            if (board.makes_five(g, player)) existing.set(g.to_index());
+        });
+        auto legal = board.get_legal_moves();
+        for (const Move& m : legal) {
+            BitBoard predicted;
+            for (int dir = 0; dir < 4; ++dir) {
+                uint8_t gains = Heuristic::four_gains(board.window_code(m.to_index(), dir), player);
+                for (int k = 0; k < 8; ++k) {
+                    if (gains & (1 << k)) predicted.set(Heuristic::window_cell(m.to_index(), dir, k));
+                }
+            }
+            board.make_move(m);
+            BitBoard actual;
+            if (!board.is_terminal()) {
+                board.for_each_legal_move([&](const Move& g) {
+                    if (board.makes_five(g, player) && !existing[g.to_index()]) actual.set(g.to_index());
+                });
+            }
+            board.unmake_move(m);
+            if (board.makes_five(m, player)) continue;
+            predicted &= ~existing;
+            ASSERT(predicted == actual);
+        }
+    }
+}
+
+static bool cache_matches(const ScoreCache& cache, const Heuristic& heuristic, const Board& board) {
+    bool ok = true;
+    board.for_each_legal_move([&](const Move& m) {
+        ScoredMove a = cache.score_move(board, m);
+        ScoredMove b = heuristic.score_move(board, m);
+        ok = ok && a.score == b.score && a.is_winning == b.is_winning && a.is_blocking == b.is_blocking;
+    });
+    return ok;
+}
+
+TEST(score_cache_consistency) {
+    Heuristic heuristic;
+    ScoreCache cache;
+    std::mt19937_64 rng(21);
+    
+    for (int game = 0; game < 20; ++game) {
+        // Patched move by move, then taken back half way
+        Board board;
+        cache.sync(board);
+        while (!board.is_terminal()) {
+            auto moves = board.get_legal_moves();
+            cache.make_move(board, moves[rng() % moves.size()]);
+            ASSERT(cache_matches(cache, heuristic, board));
+        }
+        cache.unmake_to(board, board.move_count() / 2);
+        ASSERT(cache_matches(cache, heuristic, board));
+        
+        // Jump to an unrelated position sharing only a prefix
+        Board other = midgame_position(10 + game, rng());
+        cache.sync(other);
+        ASSERT(cache_matches(cache, heuristic, other));
+    }
+}
+
+TEST(top_moves_selection) {
+    Heuristic heuristic;
+    ScoreCache cache;
+    
+    for (int game = 0; game < 20; ++game) {
+        Board board = midgame_position(5 + game * 2, 40 + game);
+        auto sorted = heuristic.get_scored_moves(board);
+        cache.sync(board);
+        
+        for (int k : {1, 3, 8}) {
+            ScoredMove top[8];
+            ScoredMove cached[8];
+            int n = heuristic.top_moves(board, k, top);
+            ASSERT(n == std::min<int>(k, sorted.size()));
+            ASSERT(cache.top_moves(board, k, cached) == n);
+            
+            // Same ranking as the full sort (ties may pick different moves)
+            for (int i = 0; i < n; ++i) {
+                ASSERT(top[i].score == sorted[i].score);
+                ASSERT(top[i].is_winning == sorted[i].is_winning);
+                ASSERT(top[i].is_blocking == sorted[i].is_blocking);
+                ASSERT(cached[i].move == top[i].move);
+            }
+        }
+    }
+}
+
+static bool same_side(const ThreatSummary::Side& a, const ThreatSummary::Side& b) {
+    return a.five == b.five && a.open_four == b.open_four && a.strongest == b.strongest &&
+           a.strongest_class == b.strongest_class && a.num_fives == b.num_fives;
+}
+
+TEST(threat_summary) {
+    Heuristic heuristic;
+    ScoreCache cache;
+    std::mt19937_64 rng(17);
+    
+    for (int game = 0; game < 40; ++game) {
+        Board board = midgame_position(10 + game, rng());
+        ThreatSummary threats = heuristic.classify_threats(board);
+        
+        // Fives match a direct scan, first in index order
+        for (int8_t player : {BLACK, WHITE}) {
+            Move first;
+            int count = 0;
+            board.for_each_legal_move([&](const Move& m) {
+                if (board.makes_five(m, player)) {
+                    if (!first.is_valid()) first = m;
+                    ++count;
+                }
+            });
+            ASSERT(threats.of(player).five == first);
+            ASSERT(threats.of(player).num_fives == count);
+        }
+        
+        // The cached sweep agrees field for field
+        cache.sync(board);
+        ThreatSummary cached = cache.classify_threats(board);
+        ASSERT(same_side(cached.of(BLACK), threats.of(BLACK)));
+        ASSERT(same_side(cached.of(WHITE), threats.of(WHITE)));
+    }
+    
+    // BLACK open three: WHITE to move must block it, BLACK could open a four
+    Board board;
+    board.make_move(6, 7);  board.make_move(0, 0);
+    board.make_move(7, 7);  board.make_move(0, 2);
+    board.make_move(8, 7);
+    ThreatSummary threats = heuristic.classify_threats(board);
+    ASSERT(threats.of(BLACK).open_four.is_valid());
+    ASSERT(threats.of(BLACK).strongest_class == LINE_FOUR_OPEN);
+    ASSERT(!threats.forced_move(WHITE).is_valid());
+    ASSERT(threats.forced_move(BLACK) == threats.of(BLACK).open_four);
+    ASSERT(heuristic.find_open_three_block(board) == threats.of(BLACK).strongest);
+}
+
+// ============================================================================
+// Solver Tests
+// ============================================================================
+
+// Replay a VCF line: every attacker move but the last makes a four whose only
+// five cell is the defender's reply, the defender never has a five of its
+// own, and the last move wins or leaves two fives
+static bool vcf_line_valid(Board board, const std::vector<Move>& line) {
+    int8_t attacker = board.current_player();
+    auto count_fives = [&](int8_t player) {
+        int n = 0;
+        board.for_each_legal_move([&](const Move& m) { n += board.makes_five(m, player); });
+        return n;
+    };
+    if (line.empty() || line.size() % 2 == 0) return false;
+    for (size_t i = 0; i + 1 < line.size(); i += 2) {
+        if (!board.is_legal(line[i])) return false;
+        board.make_move(line[i]);
+        if (board.is_terminal() || count_fives(attacker) != 1 || count_fives(-attacker) != 0) return false;
+        if (!board.makes_five(line[i + 1], attacker)) return false;
+        board.make_move(line[i + 1]);
+        if (board.is_terminal()) return false;
+    }
+    if (!board.is_legal(line.back())) return false;
+    board.make_move(line.back());
+    if (board.is_terminal()) return board.get_winner() == attacker;
+    return count_fives(attacker) >= 2 && count_fives(-attacker) == 0;
+}
+
+// BLACK to move: the closed three on row 7 becomes a four at (6,7), forcing
+// (7,7); with column 6 that stone then makes an open four
+static Board vcf_puzzle() {
+    Board board;
+    board.make_move(3, 7);  board.make_move(2, 7);
+    board.make_move(4, 7);  board.make_move(0, 0);
+    board.make_move(5, 7);  board.make_move(14, 0);
+    board.make_move(6, 8);  board.make_move(0, 14);
+    board.make_move(6, 9);  board.make_move(14, 14);
+    return board;
+}
+
+TEST(vcf_puzzles) {
+    VCFSolver solver;
+    
+    Board board = vcf_puzzle();
+    uint64_t key = board.hash();
+    VCFResult result = solver.solve(board);
+    ASSERT(result.proven);
+    ASSERT(result.line.size() == 3);
+    ASSERT(result.line[0] == Move(6, 7));
+    ASSERT(result.line[1] == Move(7, 7));
+    ASSERT(result.line[2] == Move(6, 6) || result.line[2] == Move(6, 10));
+    ASSERT(vcf_line_valid(board, result.line));
+    ASSERT(board.hash() == key && board.move_count() == 10);
+    
+    // Double four in one: row 7 closed by (2,7), column 6 closed by (6,11)
+    Board double_four;
+    double_four.make_move(3, 7);  double_four.make_move(2, 7);
+    double_four.make_move(4, 7);  double_four.make_move(6, 11);
+    double_four.make_move(5, 7);  double_four.make_move(0, 0);
+    double_four.make_move(6, 8);  double_four.make_move(14, 0);
+    double_four.make_move(6, 9);  double_four.make_move(0, 14);
+    double_four.make_move(6, 10); double_four.make_move(14, 14);
+    result = solver.solve(double_four);
+    ASSERT(result.proven);
+    ASSERT(result.line.size() == 1 && result.line[0] == Move(6, 7));
+    
+    // Column 6 closed at both ends: the row four leads nowhere
+    Board closed = vcf_puzzle();
+    closed.unmake_move(Move(14, 14));
+    closed.make_move(6, 10);
+    closed.make_move(9, 9);  closed.make_move(6, 5);
+    result = solver.solve(closed);
+    ASSERT(!result.proven);
+    ASSERT(!result.budget_exhausted);
+    
+    // A defender four must be blocked, and only a blocking four keeps the attack
+    Board threatened = vcf_puzzle();
+    threatened.unmake_move(Move(14, 14));
+    threatened.make_move(10, 1);
+    threatened.make_move(10, 0);  threatened.make_move(10, 2);
+    threatened.make_move(11, 2);  threatened.make_move(10, 3);
+    threatened.make_move(12, 2);  threatened.make_move(10, 4);
+    ASSERT(Heuristic().classify_threats(threatened).of(WHITE).num_fives == 1);
+    result = solver.solve(threatened);
+    ASSERT(!result.proven);
+    ASSERT(!result.budget_exhausted);
+    
+    // Out of budget is reported as such, not as a refutation
+    VCFSolver tiny(1);
+    board = vcf_puzzle();
+    result = tiny.solve(board);
+    ASSERT(!result.proven);
+    ASSERT(result.budget_exhausted);
+}
+
+TEST(vcf_in_mcts) {
+    MCTSConfig config;
+    config.max_iterations = 1000000;
+    config.seed = 3;
+    
+    // The root check plays the first move of the proof without searching
+    MCTS mcts(config);
+    Move best = mcts.search(vcf_puzzle(), 1000);
+    ASSERT(best == Move(6, 7));
+    ASSERT(mcts.get_iterations() == 0);
+    ASSERT(mcts.get_vcf_wins() == 1);
+    
+    // With it off the tree is searched; leaf checks only replace rollouts
+    config.max_iterations = 200;
+    config.vcf_root_nodes = 0;
+    config.vcf_leaf_nodes = 1000;
+    MCTS leaf_checked(config);
+    Board quiet;
+    quiet.make_move(7, 7);
+    quiet.make_move(8, 8);
+    leaf_checked.search(quiet, 1000);
+    ASSERT(leaf_checked.get_iterations() == 200);
+    ASSERT(leaf_checked.get_vcf_wins() == 0);
+}
+
+// Replay a VCT line: every attacker move but the last leaves it a five (a
+// four) or a cell making two fives (a three) while the defender has no five,
+// and the last move wins or leaves two fives
+static bool vct_line_valid(Board board, const std::vector<Move>& line) {
+    int8_t attacker = board.current_player();
+    int cells[Heuristic::MAX_FIVE_CELLS];
+    auto best_threat = [&](int8_t player) {
+        int best = 0;
+        board.for_each_legal_move([&](const Move& m) {
+            if (board.makes_five(m, player)) best = std::max(best, 3);
+            else best = std::max(best, std::min(2, Heuristic::five_cells(board, m.to_index(), player, cells)));
+        });
+        return best;  // 3 = five, 2 = double five, 1 = four
+    };
+    if (line.empty() || line.size() % 2 == 0) return false;
+    for (size_t i = 0; i + 1 < line.size(); i += 2) {
+        if (!board.is_legal(line[i])) return false;
+        board.make_move(line[i]);
+        if (board.is_terminal() || best_threat(attacker) < 2 || best_threat(-attacker) == 3) return false;
+        if (!board.is_legal(line[i + 1])) return false;
+        board.make_move(line[i + 1]);
+        if (board.is_terminal()) return false;
+    }
+    if (!board.is_legal(line.back())) return false;
+    board.make_move(line.back());
+    if (board.is_terminal()) return board.get_winner() == attacker;
+    int fives = 0;
+    board.for_each_legal_move([&](const Move& m) { fives += board.makes_five(m, attacker); });
+    return fives >= 2 && best_threat(-attacker) < 3;
+}
+
+// BLACK to move: open twos on row 7 and column 8 meet at (8,7), a double
+// three; no four is available
+static Board vct_puzzle() {
+    Board board;
+    board.make_move(6, 7);  board.make_move(0, 0);
+    board.make_move(7, 7);  board.make_move(14, 0);
+    board.make_move(8, 8);  board.make_move(0, 14);
+    board.make_move(8, 9);  board.make_move(14, 14);
+    return board;
+}
+
+TEST(vct_puzzles) {
+    VCTSolver solver;
+    VCFSolver vcf;
+    
+    Board board = vct_puzzle();
+    uint64_t key = board.hash();
+    ASSERT(!vcf.solve(board).proven);
+    VCTResult result = solver.solve(board);
+    ASSERT(result.proven);
+    ASSERT(result.line.front() == Move(8, 7));
+    ASSERT(vct_line_valid(board, result.line));
+    ASSERT(board.hash() == key && board.move_count() == 8);
+    
+    // WHITE's open three answers any three with an open four
+    Board countered;
+    countered.make_move(6, 7);  countered.make_move(10, 12);
+    countered.make_move(7, 7);  countered.make_move(11, 12);
+    countered.make_move(8, 8);  countered.make_move(12, 12);
+    countered.make_move(8, 9);  countered.make_move(14, 14);
+    result = solver.solve(countered);
+    ASSERT(!result.proven);
+    
+    // Time limit: a rich midgame with an unlimited node budget returns promptly
+    VCTSolver timed(~uint64_t(0), 5, 40);
+    Board midgame = midgame_position(40, 31);
+    auto start = std::chrono::high_resolution_clock::now();
+    result = timed.solve(midgame);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::high_resolution_clock::now() - start).count();
+    ASSERT(elapsed < 100);
+    ASSERT(midgame.move_count() == 40);
+    
+    // Out of nodes is reported as such
+    VCTSolver tiny(1);
+    board = vct_puzzle();
+    result = tiny.solve(board);
+    ASSERT(!result.proven);
+    ASSERT(result.limit_reached);
+}
+
+TEST(vct_in_mcts) {
+    MCTSConfig config;
+    config.max_iterations = 1000000;
+    config.seed = 3;
+    MCTS mcts(config);
+    Move best = mcts.search(vct_puzzle(), 1000);
+    ASSERT(best == Move(8, 7));
+    ASSERT(mcts.get_iterations() == 0);
+    ASSERT(mcts.get_vct_wins() == 1 && mcts.get_vcf_wins() == 0);
+    
+    // Leaf checks only replace rollouts
+    config.max_iterations = 200;
+    config.vct_root_nodes = 0;
+    config.vct_leaf_nodes = 500;
+    MCTS leaf_checked(config);
+    Board quiet;
+    quiet.make_move(7, 7);
+    quiet.make_move(8, 8);
+    leaf_checked.search(quiet, 1000);
+    ASSERT(leaf_checked.get_iterations() == 200);
+}
+
+TEST(dfpn_solver) {
+    DFPNSolver solver(16);
+    
+    // VCF puzzle: the proof starts with the four, its line replays as one
+    Board board = vcf_puzzle();
+    uint64_t key = board.hash();
+    DFPNResult result = solver.solve(board, 100000);
+    ASSERT(result.outcome == DFPNResult::PROVEN);
+    ASSERT(result.best == Move(6, 7));
+    ASSERT(vct_line_valid(board, result.line));
+    ASSERT(result.proof_size >= 3);
+    ASSERT(board.hash() == key && board.move_count() == 10);
+    
+    // Double three: proven through threes
+    board = vct_puzzle();
+    result = solver.solve(board, 100000);
+    ASSERT(result.outcome == DFPNResult::PROVEN);
+    ASSERT(vct_line_valid(board, result.line));
+    
+    // Entries of the last solve are not reused: solving again does the
+    // same work
+    DFPNResult again = solver.solve(board, 100000);
+    ASSERT(again.nodes == result.nodes);
+    ASSERT(again.line == result.line);
+    
+    // No threats at all, or a defender open three against any three
+    Board quiet;
+    quiet.make_move(7, 7);
+    quiet.make_move(8, 8);
+    ASSERT(solver.solve(quiet, 100000).outcome == DFPNResult::DISPROVEN);
+    Board countered;
+    countered.make_move(6, 7);  countered.make_move(10, 12);
+    countered.make_move(7, 7);  countered.make_move(11, 12);
+    countered.make_move(8, 8);  countered.make_move(12, 12);
+    countered.make_move(8, 9);  countered.make_move(14, 14);
+    ASSERT(solver.solve(countered, 100000).outcome == DFPNResult::DISPROVEN);
+    
+    // A tiny table loses entries (and parts of the proof tree) but not
+    // correctness; a tiny budget gives up
+    DFPNSolver small(4);
+    board = vct_puzzle();
+    ASSERT(small.solve(board, 1000000).outcome == DFPNResult::PROVEN);
+    ASSERT(solver.solve(board, 2).outcome == DFPNResult::UNKNOWN);
+    
+    // Agrees with the VCT solver: a VCT proof is never disproven
+    VCTSolver vct;
+    std::mt19937_64 rng(37);
+    for (int i = 0; i < 30; ++i) {
+        Board midgame = midgame_position(20 + i, rng());
+        result = solver.solve(midgame, 200000);
+        if (result.outcome == DFPNResult::PROVEN) ASSERT(vct_line_valid(midgame, result.line));
+        if (vct.solve(midgame).proven) ASSERT(result.outcome != DFPNResult::DISPROVEN);
+    }
+}
+
+TEST(uci_solve) {
+    // Double three at i8 (x=8, y=7), set up with moves near each other
+    UCIEngine engine;
+    engine.process_command("position startpos moves g8 e9 h8 j6 i9 k11 i10 f10");
+    std::string reply = engine.process_command("solve nodes 100000");
+    ASSERT(reply.rfind("result proven bestmove ", 0) == 0);
+    ASSERT(reply.find(" proofsize ") != std::string::npos);
+    ASSERT(reply.find(" nodes ") != std::string::npos);
+    ASSERT(reply.find(" nps ") != std::string::npos);
+    
+    engine.process_command("position startpos moves h8 i9");
+    reply = engine.process_command("solve");
+    ASSERT(reply.rfind("result disproven nodes ", 0) == 0);
+}
+
 // ============================================================================
 // MCTS Tests
 // ============================================================================
@@ -267,6 +911,478 @@ TEST(mcts_defensive_necessity) {
     ASSERT(best.x == 2 || best.x == 7);
 }
 
+TEST(mcts_forced_short_circuit) {
+    MCTSConfig config;
+    config.max_iterations = 1000000;
+    config.seed = 5;
+    MCTS mcts(config);
+    
+    // WHITE to move must block BLACK's four at (9,7)
+    Board board;
+    board.make_move(5, 7);  board.make_move(4, 7);
+    board.make_move(6, 7);  board.make_move(5, 8);
+    board.make_move(7, 7);  board.make_move(6, 9);
+    board.make_move(8, 7);
+    
+    // A one-second budget is not spent on a forced reply
+    auto start = std::chrono::high_resolution_clock::now();
+    Move best = mcts.search(board, 1000);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::high_resolution_clock::now() - start).count();
+    
+    ASSERT(best == Move(9, 7));
+    ASSERT(elapsed < 100);
+    ASSERT(mcts.get_iterations() == 0);
+    ASSERT(mcts.get_short_circuits() == 1);
+    
+    // A quiet position is searched as usual
+    Board quiet;
+    quiet.make_move(7, 7);
+    quiet.make_move(8, 8);
+    config.max_iterations = 200;
+    MCTS searcher(config);
+    searcher.search(quiet, 1000);
+    ASSERT(searcher.get_iterations() == 200);
+    ASSERT(searcher.get_short_circuits() == 0);
+    ASSERT(searcher.get_answer() == SearchAnswer::SEARCH);
+    
+    // A forced reply does not report the last tree's statistics, but keeps
+    // the tree for the next search to reuse
+    ASSERT(searcher.search(board, 1000) == Move(9, 7));
+    ASSERT(searcher.get_answer() == SearchAnswer::FORCED);
+    ASSERT(searcher.get_iterations() == 0);
+    ASSERT(searcher.get_root_visits() == 0);
+    ASSERT(searcher.get_node_count() == 0);
+    ASSERT(!searcher.get_most_visited_move().is_valid());
+    searcher.search(quiet, 1000);
+    ASSERT(searcher.get_root_visits() == 400);
+    
+    // UCI names the forced move on an info line before bestmove
+    UCIEngine engine;
+    std::string info;
+    engine.set_output_handler([&](const std::string& msg) { info += msg; });
+    engine.process_command("position startpos moves f8 e8 g8 f9 h8 g10 i8");
+    ASSERT(engine.process_command("go movetime 1000") == "bestmove j8");
+    ASSERT(info == "info string forced move j8");
+}
+
+TEST(mcts_solver) {
+    // VCF puzzle with the root solvers off: the four, the forced block, the
+    // open four and the rest are single-edge nodes, so the tree proves the
+    // win from terminal nodes and stops early
+    MCTSConfig config;
+    config.max_iterations = 20000;
+    config.max_time_ms = 10000;
+    config.seed = 11;
+    config.vcf_root_nodes = 0;
+    config.vct_root_nodes = 0;
+    MCTS mcts(config);
+    Move best = mcts.search(vcf_puzzle());
+    ASSERT(best == Move(6, 7));
+    ASSERT(mcts.get_root_proof() == PROVEN_LOSS);  // Lost for WHITE, who moved last
+    ASSERT(mcts.get_iterations() < config.max_iterations);
+    
+    // Leaf VCF proofs mark nodes too, and a quiet position stays open
+    config.vcf_leaf_nodes = 1000;
+    MCTS leaf_proofs(config);
+    ASSERT(leaf_proofs.search(vcf_puzzle()) == Move(6, 7));
+    ASSERT(leaf_proofs.get_root_proof() == PROVEN_LOSS);
+    
+    Board quiet;
+    quiet.make_move(7, 7);
+    quiet.make_move(8, 8);
+    config.max_iterations = 300;
+    MCTS open(config);
+    open.search(quiet);
+    ASSERT(open.get_root_proof() == UNPROVEN);
+    ASSERT(open.get_iterations() == 300);
+}
+
+TEST(mcts_solver_widening) {
+    // BLACK to move against two open threes of WHITE, with no fours of its
+    // own: every move loses. The root's four candidates are proven lost
+    // first, then it widens to every legal move and is proven as well.
+    Board board;
+    const int stones[][2] = {{7, 7}, {3, 3}, {13, 1}, {4, 3}, {1, 12}, {5, 3},
+                             {8, 13}, {11, 9}, {2, 8}, {11, 10}, {14, 13}, {11, 11}};
+    for (const auto& s : stones) board.make_move(s[0], s[1]);
+    
+    MCTSConfig config;
+    config.max_iterations = 5000;
+    config.max_time_ms = 10000;
+    config.seed = 11;
+    config.vcf_root_nodes = 0;
+    config.vct_root_nodes = 0;
+    config.max_children = 4;
+    MCTS mcts(config);
+    mcts.search(board);
+    ASSERT(mcts.get_root_proof() == PROVEN_WIN);  // Won for WHITE, who moved last
+    ASSERT(mcts.get_root_children() == board.count_legal_moves());
+    ASSERT(mcts.get_iterations() < config.max_iterations);
+}
+
+TEST(mcts_puct) {
+    MCTSConfig config;
+    config.max_iterations = 1;
+    config.max_time_ms = 10000;
+    config.seed = 11;
+    config.vcf_root_nodes = 0;
+    config.vct_root_nodes = 0;
+    config.selection = SelectionRule::PUCT;
+    
+    // The first playout follows the highest prior, the heuristic's best move
+    Board board = midgame_position(20, 6);
+    MCTS first(config);
+    first.search(board);
+    Heuristic heuristic;
+    ScoredMove best[1];
+    heuristic.top_moves(board, 1, best);
+    ASSERT(heuristic.score_move(board, first.get_most_visited_move()).score == best[0].score);
+    
+    // Unvisited children are not all tried first: with fewer playouts than
+    // candidates UCT only opens root children, PUCT also goes deeper
+    config.max_iterations = 30;
+    MCTSConfig uct_config = config;
+    uct_config.selection = SelectionRule::UCT;
+    uct_config.widening_constant = 0.0;
+    MCTS uct(uct_config);
+    uct.search(board);
+    MCTS deep(config);
+    deep.search(board);
+    ASSERT(uct.get_root_children() == 30);
+    ASSERT(deep.get_root_visits() == 30);
+    ASSERT(deep.get_root_children() < 30);
+    
+    // The MCTS-Solver works the same under PUCT
+    config.max_iterations = 20000;
+    MCTS solver(config);
+    ASSERT(solver.search(vcf_puzzle()) == Move(6, 7));
+    ASSERT(solver.get_root_proof() == PROVEN_LOSS);
+    ASSERT(solver.get_iterations() < config.max_iterations);
+}
+
+TEST(arena_ranges) {
+    Arena<int, 4> arena; // 16 elements per chunk
+    
+    auto a = arena.allocate(10);
+    auto b = arena.allocate(10); // Does not fit the first chunk's tail
+    ASSERT(a == 0);
+    ASSERT(b == 16);
+    for (int i = 0; i < 10; ++i) arena[b + i] = i;
+    ASSERT(arena.ptr(b) + 9 == arena.ptr(b + 9)); // Contiguous range
+    
+    size_t capacity = arena.capacity();
+    arena.reset();
+    ASSERT(arena.size() == 0);
+    ASSERT(arena.allocate(16) == 0);
+    ASSERT(arena.capacity() == capacity); // Chunks are reused
+}
+
+TEST(mcts_tree_reset) {
+    Board board;
+    MCTSConfig config;
+    config.max_iterations = 200;
+    config.max_time_ms = 10000;
+    config.seed = 42;
+    config.reuse_tree = false;
+    MCTS mcts(config);
+    
+    board.make_move(7, 7);
+    board.make_move(8, 8);
+    
+    mcts.search(board);
+    size_t first = mcts.get_node_count();
+    
+    // One node per iteration plus the root (unless the iteration reached a
+    // transposition), rebuilt from scratch each search
+    ASSERT(first + mcts.get_transpositions() == static_cast<size_t>(mcts.get_iterations()) + 1);
+    mcts.search(board);
+    ASSERT(mcts.get_node_count() + mcts.get_transpositions() == static_cast<size_t>(mcts.get_iterations()) + 1);
+}
+
+TEST(mcts_subtree_reuse) {
+    Board board;
+    MCTSConfig config;
+    config.max_iterations = 2000;
+    config.max_time_ms = 10000;
+    config.seed = 42;
+    MCTS mcts(config);
+    
+    board.make_move(7, 7);
+    board.make_move(8, 8);
+    
+    // Our move, then the opponent's most likely reply is already in the tree
+    Move ours = mcts.search(board);
+    board.make_move(ours);
+    Move reply = mcts.search(board);
+    int reply_visits = mcts.get_root_visits();
+    board.make_move(reply);
+    
+    mcts.config().max_iterations = 100;
+    mcts.search(board);
+    
+    // The promoted root kept its visits and the rest of the tree was freed
+    ASSERT(mcts.get_root_visits() > mcts.get_iterations());
+    ASSERT(mcts.get_node_count() < static_cast<size_t>(reply_visits + 100));
+    
+    // A position that does not follow from the tree starts from scratch
+    Board other;
+    other.make_move(3, 3);
+    mcts.search(other);
+    ASSERT(mcts.get_root_visits() == mcts.get_iterations());
+}
+
+TEST(mcts_tree_parallel) {
+    Board board;
+    MCTSConfig config;
+    config.max_iterations = 2000;
+    config.max_time_ms = 20000;
+    config.seed = 42;
+    config.num_threads = 4;
+    config.reuse_tree = false;
+    MCTS mcts(config);
+    
+    board.make_move(7, 7);
+    board.make_move(8, 7);
+    board.make_move(7, 8);
+    
+    Move best = mcts.search(board);
+    ASSERT(best.is_valid());
+    ASSERT(board.is_legal(best));
+    
+    // Every iteration was backed up exactly once, by some thread
+    int iterations = mcts.get_iterations();
+    ASSERT(iterations >= config.max_iterations);
+    ASSERT(iterations < config.max_iterations + config.num_threads);
+    ASSERT(mcts.get_root_visits() == iterations);
+    
+    // At most one new node or transposition link per iteration: a thread
+    // that finds its leaf already fully expanded by another thread rolls
+    // out from it instead, so the count can fall short of the iterations
+    ASSERT(mcts.get_node_count() + mcts.get_transpositions() <= static_cast<size_t>(iterations) + 1);
+}
+
+TEST(mcts_root_parallel) {
+    Board board;
+    MCTSConfig config;
+    config.max_iterations = 1500;
+    config.max_time_ms = 20000;
+    config.seed = 42;
+    config.num_threads = 3;
+    config.parallel_mode = ParallelMode::ROOT;
+    config.reuse_tree = false;
+    MCTS mcts(config);
+    
+    board.make_move(7, 7);
+    board.make_move(8, 7);
+    board.make_move(7, 8);
+    
+    Move best = mcts.search(board);
+    ASSERT(best.is_valid());
+    ASSERT(board.is_legal(best));
+    
+    // Each tree ran its share of the budget; our own tree holds only one share
+    ASSERT(mcts.get_iterations() == config.max_iterations);
+    ASSERT(mcts.get_root_visits() == config.max_iterations / config.num_threads);
+}
+
+TEST(mcts_transpositions) {
+    Board board;
+    board.make_move(7, 7);
+    board.make_move(8, 7);
+    board.make_move(7, 8);
+    
+    MCTSConfig config;
+    config.max_iterations = 3000;
+    config.max_time_ms = 20000;
+    config.seed = 42;
+    
+    config.use_transpositions = false;
+    MCTS tree_search(config);
+    tree_search.search(board);
+    
+    config.use_transpositions = true;
+    MCTS dag_search(config);
+    dag_search.search(board);
+    
+    // Transposed move orders share nodes instead of duplicating them
+    std::cout << "[" << tree_search.get_node_count() << " -> " << dag_search.get_node_count() << " nodes] ";
+    ASSERT(tree_search.get_transpositions() == 0);
+    ASSERT(dag_search.get_transpositions() > 0);
+    ASSERT(dag_search.get_node_count() < tree_search.get_node_count());
+    ASSERT(dag_search.get_root_visits() == dag_search.get_iterations());
+}
+
+TEST(mcts_progressive_widening) {
+    // A quiet midgame with over a hundred legal moves
+    Board board = midgame_position(20, 6);
+    ASSERT(!Heuristic().classify_threats(board).forced_move(board.current_player()).is_valid());
+    
+    MCTSConfig config;
+    config.max_iterations = 2000;
+    config.max_time_ms = 20000;
+    config.seed = 42;
+    config.vcf_root_nodes = 0;
+    config.vct_root_nodes = 0;
+    
+    MCTSConfig full_config = config;
+    full_config.max_children = 0;
+    full_config.widening_constant = 0.0;
+    
+    // Same seed, same trees each round; the two alternate and keep their
+    // best time so a stall on a shared machine does not land on one only
+    auto timed_search = [&](const MCTSConfig& cfg, size_t& nodes, size_t& edges) {
+        MCTS mcts(cfg);
+        auto t0 = std::chrono::high_resolution_clock::now();
+        mcts.search(board);
+        auto t1 = std::chrono::high_resolution_clock::now();
+        nodes = mcts.get_node_count();
+        edges = mcts.get_edge_count();
+        return std::chrono::duration<double, std::micro>(t1 - t0).count() / mcts.get_iterations();
+    };
+    size_t full_nodes = 0, full_edge_count = 0, nodes = 0, edges = 0;
+    double full_us = 1e18, widened_us = 1e18;
+    for (int round = 0; round < 3; ++round) {
+        full_us = std::min(full_us, timed_search(full_config, full_nodes, full_edge_count));
+        widened_us = std::min(widened_us, timed_search(config, nodes, edges));
+    }
+    
+    // Nodes keep only their best candidates
+    double full_edges = double(full_edge_count) / full_nodes;
+    double widened_edges = double(edges) / nodes;
+    size_t full_bytes = full_nodes * sizeof(MCTSNode) + full_edge_count * sizeof(MCTSEdge);
+    size_t widened_bytes = nodes * sizeof(MCTSNode) + edges * sizeof(MCTSEdge);
+    std::cout << "[edges/node " << full_edges << " -> " << widened_edges << ", tree "
+              << full_bytes / 1024 << " -> " << widened_bytes / 1024 << " KiB, "
+              << full_us << " -> " << widened_us << " μs/iter] ";
+    ASSERT(edges <= nodes * config.max_children);
+    ASSERT(widened_edges < full_edges);
+    ASSERT(2 * widened_bytes < full_bytes);
+    // Deeper trees cost longer descents; allow a little for timer noise
+    ASSERT(widened_us < 1.1 * full_us);
+    
+    // The first child expanded is the heuristic's best move
+    config.max_iterations = 1;
+    MCTS first(config);
+    first.search(board);
+    Heuristic heuristic;
+    ScoredMove best[1];
+    heuristic.top_moves(board, 1, best);
+    ASSERT(heuristic.score_move(board, first.get_most_visited_move()).score == best[0].score);
+}
+
+TEST(time_manager) {
+    TimeManager manager(20);
+    TimeControl control;
+    control.time_ms = 60000;
+    
+    // Budgets stay within the clock, and max leaves room to extend
+    for (int moves : {0, 10, 30, 60, 120}) {
+        TimeBudget budget = manager.allocate(control, moves);
+        ASSERT(budget.target_ms > 0);
+        ASSERT(budget.target_ms <= budget.max_ms);
+        ASSERT(budget.max_ms <= control.time_ms - manager.overhead_ms());
+    }
+    
+    // The middlegame gets more than the opening, fewer moves to go or an
+    // increment more per move, and the last move before the control most
+    // of what is left
+    ASSERT(manager.allocate(control, 20).target_ms > manager.allocate(control, 0).target_ms);
+    TimeBudget base = manager.allocate(control, 20);
+    ASSERT(base.max_ms > base.target_ms);
+    TimeControl incremented = control;
+    incremented.increment_ms = 1000;
+    ASSERT(manager.allocate(incremented, 20).target_ms > base.target_ms);
+    TimeControl few = control;
+    few.moves_to_go = 5;
+    ASSERT(manager.allocate(few, 20).target_ms > base.target_ms);
+    few.moves_to_go = 1;
+    ASSERT(manager.allocate(few, 20).max_ms > control.time_ms / 2);
+    
+    // An empty clock still gets a minimal, positive budget
+    TimeControl empty;
+    TimeBudget last = manager.allocate(empty, 40);
+    ASSERT(last.target_ms >= 1 && last.max_ms >= last.target_ms);
+}
+
+TEST(mcts_time_extension) {
+    Board board = midgame_position(20, 6);
+    MCTSConfig config;
+    config.max_iterations = 1000000;
+    config.seed = 42;
+    config.vcf_root_nodes = 0;
+    config.vct_root_nodes = 0;
+    
+    // Without room to extend, the search stops at its target
+    MCTS fixed(config);
+    auto t0 = std::chrono::high_resolution_clock::now();
+    fixed.search(board, 60, 60);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    ASSERT(fixed.get_extensions() == 0);
+    
+    // With room, extensions run while the best move changes, within max
+    MCTS extended(config);
+    extended.search(board, 60, 300);
+    auto t2 = std::chrono::high_resolution_clock::now();
+    double fixed_ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+    double extended_ms = std::chrono::duration<double, std::milli>(t2 - t1).count();
+    std::cout << "[" << fixed_ms << " ms fixed, " << extended_ms << " ms with "
+              << extended.get_extensions() << " extensions] ";
+    ASSERT(extended_ms < 300 + 100);
+    ASSERT(extended.get_extensions() <= (300 - 60) / 30 + 1);
+    ASSERT(extended.get_root_visits() == extended.get_iterations());
+    
+    // Root-parallel trees are extended together
+    config.num_threads = 2;
+    config.parallel_mode = ParallelMode::ROOT;
+    MCTS root_parallel(config);
+    ASSERT(root_parallel.search(board, 40, 200).is_valid());
+    ASSERT(root_parallel.get_iterations() > root_parallel.get_root_visits());
+}
+
+TEST(mcts_solver_time_budget) {
+    // The root VCT runs into its time limit here without a proof; that time
+    // comes out of the move's budget instead of being added to it
+    Board board = midgame_position(14, 2);
+    MCTSConfig config;
+    config.max_iterations = 1000000;
+    config.seed = 42;
+    config.vct_root_nodes = 10000000;
+    config.vct_root_ms = 50;
+    MCTS mcts(config);
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    mcts.search(board, 200);
+    double spent_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - start).count();
+    std::cout << "[" << spent_ms << " ms of 200] ";
+    ASSERT(mcts.get_answer() == SearchAnswer::SEARCH);
+    ASSERT(mcts.get_iterations() > 0);
+    ASSERT(spent_ms < 200 + 30);
+}
+
+TEST(uci_go_clock) {
+    // BLACK to move with 2 s left: the time manager spends a fraction of it
+    UCIEngine engine;
+    engine.process_command("position startpos moves h8 i9 g7 j10");
+    auto start = std::chrono::high_resolution_clock::now();
+    std::string reply = engine.process_command("go btime 2000 wtime 60000 binc 0 winc 0");
+    auto end = std::chrono::high_resolution_clock::now();
+    double spent_ms = std::chrono::duration<double, std::milli>(end - start).count();
+    ASSERT(reply.rfind("bestmove ", 0) == 0);
+    ASSERT(spent_ms < 2000 * 0.5);
+    
+    // movestogo 1 may use most of the clock; movetime still wins over clocks
+    reply = engine.process_command("go btime 300 wtime 300 movestogo 1");
+    ASSERT(reply.rfind("bestmove ", 0) == 0);
+    start = std::chrono::high_resolution_clock::now();
+    reply = engine.process_command("go movetime 50 btime 100000 wtime 100000");
+    end = std::chrono::high_resolution_clock::now();
+    spent_ms = std::chrono::duration<double, std::milli>(end - start).count();
+    ASSERT(reply.rfind("bestmove ", 0) == 0);
+    ASSERT(spent_ms < 1000);
+}
+
 // ============================================================================
 // Performance Tests
 // ============================================================================
@@ -296,6 +1412,95 @@ TEST(move_performance) {
     ASSERT(per_op < 10000); // 10 μs max
 }
 
+static uint64_t perft(Board& board, int depth) {
+    if (depth == 0) return 1;
+    if (board.is_terminal()) return 0;
+    uint64_t count = 0;
+    for (const auto& m : board.get_legal_moves()) {
+        board.make_move(m);
+        count += perft(board, depth - 1);
+        board.unmake_move(m);
+    }
+    return count;
+}
+
+TEST(perft_performance) {
+    // Make/unmake cost late in the game, where history is long
+    Board board = midgame_position(40, 11);
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    uint64_t nodes = perft(board, 2);
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    double per_node = static_cast<double>(duration) / nodes;
+    
+    std::cout << "[perft 2 @ move 40: " << nodes << " nodes, " << per_node << " ns/node] ";
+    
+    ASSERT(board.move_count() == 40);
+    ASSERT(board.hash() == board.compute_hash());
+    ASSERT(per_node < 100000);
+}
+
+TEST(movegen_performance) {
+    Board board = midgame_position(20, 5);
+    const int iterations = 100000;
+    
+    // Reference: freshly allocated vector per call
+    auto start = std::chrono::high_resolution_clock::now();
+    long generated = 0;
+    for (int i = 0; i < iterations; ++i) {
+        generated += board.get_legal_moves().size();
+    }
+    auto mid = std::chrono::high_resolution_clock::now();
+    
+    // Allocation-free: caller-provided list filled by ctz iteration
+    MoveList list;
+    long generated_list = 0;
+    for (int i = 0; i < iterations; ++i) {
+        board.get_legal_moves(list);
+        generated_list += list.size();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    
+    double vec_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(mid - start).count();
+    double list_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - mid).count();
+    std::cout << "[vector " << generated / vec_ns * 1000 << " M moves/s, list "
+              << generated_list / list_ns * 1000 << " M moves/s] ";
+    
+    ASSERT(generated == generated_list);
+    ASSERT(list.size() == board.count_legal_moves());
+    
+    std::vector<Move> visited;
+    board.for_each_legal_move([&](const Move& m) { visited.push_back(m); });
+    ASSERT(visited == board.get_legal_moves());
+}
+
+TEST(win_check_performance) {
+    Board board = midgame_position(40, 11);
+    MoveList legal;
+    board.get_legal_moves(legal);
+    const int rounds = 20000;
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    int scan_hits = 0;
+    for (int r = 0; r < rounds; ++r) {
+        for (const auto& m : legal) scan_hits += scan_makes_five(board, m, BLACK);
+    }
+    auto mid = std::chrono::high_resolution_clock::now();
+    int mask_hits = 0;
+    for (int r = 0; r < rounds; ++r) {
+        for (const auto& m : legal) mask_hits += board.makes_five(m, BLACK);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    
+    double checks = static_cast<double>(rounds) * legal.size();
+    double scan_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(mid - start).count() / checks;
+    double mask_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - mid).count() / checks;
+    std::cout << "[scan " << scan_ns << " ns, line mask " << mask_ns << " ns per check] ";
+    
+    ASSERT(scan_hits == mask_hits);
+}
+
 TEST(heuristic_performance) {
     Board board;
     Heuristic heuristic;
@@ -327,6 +1532,241 @@ TEST(heuristic_performance) {
     ASSERT(per_op < 100000); // 100 μs max
 }
 
+TEST(rollout_ply_performance) {
+    // Heuristic rollouts (top-3 random pick) from a midgame position,
+    // rescoring every ply vs. patching the score cache. The two sides
+    // alternate over several rounds and each keeps its best rate, so a
+    // stall on a shared machine does not land on one side only.
+    Heuristic heuristic;
+    Board start = midgame_position(20, 13);
+    const int rollouts = 200;
+    const int rounds = 7;
+    
+    auto rescore_rate = [&] {
+        std::mt19937_64 rng(1);
+        long plies = 0;
+        auto t0 = std::chrono::high_resolution_clock::now();
+        for (int r = 0; r < rollouts; ++r) {
+            Board board = start;
+            for (int n = 0; n < 50 && !board.is_terminal(); ++n) {
+                auto scored = heuristic.get_scored_moves(board);
+                board.make_move(scored[rng() % std::min<size_t>(3, scored.size())].move);
+                ++plies;
+            }
+        }
+        auto t1 = std::chrono::high_resolution_clock::now();
+        return plies / std::chrono::duration<double>(t1 - t0).count();
+    };
+    
+    bool restored = true;
+    auto cached_rate = [&] {
+        std::mt19937_64 rng(1);
+        long plies = 0;
+        ScoreCache cache;
+        ScoredMove top[3];
+        Board board = start;
+        cache.sync(board);
+        auto t0 = std::chrono::high_resolution_clock::now();
+        for (int r = 0; r < rollouts; ++r) {
+            for (int n = 0; n < 50 && !board.is_terminal(); ++n) {
+                int top_n = cache.top_moves(board, 3, top);
+                cache.make_move(board, top[rng() % top_n].move);
+                ++plies;
+            }
+            cache.unmake_to(board, start.move_count());
+        }
+        auto t1 = std::chrono::high_resolution_clock::now();
+        restored = restored && board.move_count() == start.move_count() && plies > 0;
+        return plies / std::chrono::duration<double>(t1 - t0).count();
+    };
+    
+    double full = 0.0, cached = 0.0;
+    for (int round = 0; round < rounds; ++round) {
+        full = std::max(full, rescore_rate());
+        cached = std::max(cached, cached_rate());
+    }
+    std::cout << "[rescore+sort " << static_cast<long>(full) << " plies/s, cache+top-k "
+              << static_cast<long>(cached) << " plies/s, " << cached / full << "x] ";
+    
+    ASSERT(restored);
+    // Target: at least 5x the plies per second of rescoring every ply
+    ASSERT(cached >= 5.0 * full);
+}
+
+TEST(vcf_performance) {
+    // Solve time per position over random midgames without a forced move
+    // (those never reach the solver in play), proofs checked by replay
+    Heuristic heuristic;
+    VCFSolver solver(100000);
+    std::mt19937_64 rng(29);
+    const int positions = 200;
+    int proven = 0;
+    size_t line_moves = 0;
+    uint64_t nodes = 0;
+    double total_us = 0.0, max_us = 0.0;
+    
+    for (int i = 0; i < positions; ++i) {
+        Board board = midgame_position(20 + i % 40, rng());
+        while (heuristic.classify_threats(board).forced_move(board.current_player()).is_valid()) {
+            board = midgame_position(20 + i % 40, rng());
+        }
+        auto t0 = std::chrono::high_resolution_clock::now();
+        VCFResult result = solver.solve(board);
+        auto t1 = std::chrono::high_resolution_clock::now();
+        double us = std::chrono::duration<double, std::micro>(t1 - t0).count();
+        total_us += us;
+        max_us = std::max(max_us, us);
+        nodes += result.nodes;
+        if (result.proven) {
+            ++proven;
+            line_moves += result.line.size();
+            ASSERT(vcf_line_valid(board, result.line));
+        }
+    }
+    
+    std::cout << "[" << proven << "/" << positions << " proven, avg line "
+              << (proven ? static_cast<double>(line_moves) / proven : 0.0) << ", "
+              << total_us / positions << " μs/position (max " << max_us << " μs), "
+              << static_cast<long>(nodes / (total_us * 1e-6)) << " nodes/s] ";
+    ASSERT(proven > 0);
+}
+
+TEST(vct_performance) {
+    // Same suite as vcf_performance: VCT adds threes, so it proves more
+    // positions at a higher cost; proof lines are checked by replay
+    Heuristic heuristic;
+    VCFSolver vcf(100000);
+    VCTSolver solver(20000, 0);
+    std::mt19937_64 rng(29);
+    const int positions = 200;
+    int proven = 0, vcf_proven = 0, cut = 0;
+    uint64_t nodes = 0;
+    double total_us = 0.0, max_us = 0.0;
+    
+    for (int i = 0; i < positions; ++i) {
+        Board board = midgame_position(20 + i % 40, rng());
+        while (heuristic.classify_threats(board).forced_move(board.current_player()).is_valid()) {
+            board = midgame_position(20 + i % 40, rng());
+        }
+        bool by_fours = vcf.solve(board).proven;
+        auto t0 = std::chrono::high_resolution_clock::now();
+        VCTResult result = solver.solve(board);
+        auto t1 = std::chrono::high_resolution_clock::now();
+        double us = std::chrono::duration<double, std::micro>(t1 - t0).count();
+        total_us += us;
+        max_us = std::max(max_us, us);
+        nodes += result.nodes;
+        cut += result.limit_reached;
+        vcf_proven += by_fours;
+        if (result.proven) {
+            ++proven;
+            ASSERT(vct_line_valid(board, result.line));
+        }
+        // Fours are threats too; VCT misses a VCF only when cut off
+        ASSERT(result.proven || !by_fours || result.limit_reached);
+    }
+    
+    std::cout << "[" << proven << "/" << positions << " proven (VCF " << vcf_proven << "), "
+              << cut << " cut, " << total_us / positions << " μs/position (max "
+              << max_us << " μs), " << static_cast<long>(nodes / (total_us * 1e-6)) << " nodes/s] ";
+    ASSERT(proven >= vcf_proven - cut);
+}
+
+TEST(dfpn_performance) {
+    // Same suite again through df-pn: solve time and nodes/s per position
+    Heuristic heuristic;
+    DFPNSolver solver;
+    std::mt19937_64 rng(29);
+    const int positions = 200;
+    int proven = 0, disproven = 0;
+    uint64_t nodes = 0, proof_nodes = 0;
+    double total_s = 0.0, max_s = 0.0;
+    
+    for (int i = 0; i < positions; ++i) {
+        Board board = midgame_position(20 + i % 40, rng());
+        while (heuristic.classify_threats(board).forced_move(board.current_player()).is_valid()) {
+            board = midgame_position(20 + i % 40, rng());
+        }
+        DFPNResult result = solver.solve(board, 20000);
+        total_s += result.seconds;
+        max_s = std::max(max_s, result.seconds);
+        nodes += result.nodes;
+        if (result.outcome == DFPNResult::PROVEN) {
+            ++proven;
+            proof_nodes += result.proof_size;
+            ASSERT(vct_line_valid(board, result.line));
+        }
+        disproven += result.outcome == DFPNResult::DISPROVEN;
+    }
+    
+    std::cout << "[" << proven << " proven, " << disproven << " disproven of " << positions
+              << ", avg proof " << (proven ? proof_nodes / proven : 0) << ", "
+              << total_s * 1e6 / positions << " μs/position (max " << max_s * 1e6 << " μs), "
+              << static_cast<long>(nodes / total_s) << " nodes/s] ";
+    ASSERT(proven > 0);
+}
+
+TEST(selection_convergence) {
+    // Playouts until the most visited root move is a winning one, with and
+    // without RAVE and with PUCT, on positions where the side to move wins
+    // by threats; root solvers are off so the tree has to find the win
+    Heuristic heuristic;
+    VCFSolver vcf(100000);
+    VCTSolver vct(20000);
+    std::mt19937_64 rng(5);
+    std::vector<std::pair<Board, Move>> suite;
+    while (suite.size() < 8) {
+        Board board = midgame_position(16 + rng() % 30, rng());
+        ThreatSummary threats = heuristic.classify_threats(board);
+        if (threats.forced_move(board.current_player()).is_valid() ||
+            threats.of(-board.current_player()).strongest.is_valid() || vcf.solve(board).proven) {
+            continue;
+        }
+        VCTResult result = vct.solve(board);
+        if (result.proven) suite.emplace_back(board, result.line.front());
+    }
+    
+    const int step = 100, max_playouts = 2000;
+    MCTSConfig base;
+    base.seed = 1;
+    base.max_iterations = step;
+    base.max_time_ms = 100000;
+    base.vcf_root_nodes = 0;
+    base.vct_root_nodes = 0;
+    auto playouts_to_find = [&](const MCTSConfig& config) {
+        int total = 0;
+        for (const auto& [board, win] : suite) {
+            MCTS mcts(config);
+            // The tree is reused, so every search adds another step
+            int used = 0;
+            while (used < max_playouts) {
+                mcts.search(board);
+                used += mcts.get_iterations();
+                if (mcts.get_most_visited_move() == win || mcts.get_root_proof() == PROVEN_LOSS) break;
+            }
+            total += std::min(used, max_playouts);
+        }
+        return total;
+    };
+    
+    // RAVE on its own: every child is open from the first visit
+    MCTSConfig config = base;
+    config.max_children = 0;
+    config.widening_constant = 0.0;
+    config.use_rave = false;
+    int uct = playouts_to_find(config);
+    config.use_rave = true;
+    int rave = playouts_to_find(config);
+    config = base;
+    config.selection = SelectionRule::PUCT;
+    int puct = playouts_to_find(config);
+    
+    std::cout << "[avg playouts UCT " << uct / suite.size() << ", RAVE " << rave / suite.size()
+              << ", PUCT " << puct / suite.size() << " over " << suite.size() << " positions] ";
+    ASSERT(rave <= uct);
+    ASSERT(puct < static_cast<int>(suite.size()) * max_playouts);
+}
+
 TEST(mcts_iteration_performance) {
     Board board;
     MCTSConfig config;
@@ -352,6 +1792,42 @@ TEST(mcts_iteration_performance) {
     ASSERT(per_iter < 1000); // 1 ms max per iteration
 }
 
+TEST(mcts_thread_scaling) {
+    Board board;
+    board.make_move(7, 7);
+    board.make_move(8, 7);
+    
+    // Playouts per second with a shared tree and with independent trees.
+    // Thread counts the machine has cores for must stay near linear
+    // scaling, at least 3/4 of it; beyond that this only reports the numbers
+    int cores = static_cast<int>(std::thread::hardware_concurrency());
+    for (ParallelMode mode : {ParallelMode::TREE, ParallelMode::ROOT}) {
+        double single_rate = 0.0;
+        for (int threads : {1, 2, 4, 8, 16}) {
+            MCTSConfig config;
+            config.max_iterations = 1 << 30;
+            config.max_time_ms = 200;
+            config.seed = 42;
+            config.num_threads = threads;
+            config.parallel_mode = mode;
+            config.vcf_root_nodes = 0;  // Time only the parallel part
+            config.vct_root_nodes = 0;
+            MCTS mcts(config);
+            mcts.search(board);
+            double rate = mcts.get_iterations() * 1000.0 / config.max_time_ms;
+            std::cout << "[" << (mode == ParallelMode::TREE ? "tree " : "root ") << threads
+                      << "T: " << static_cast<int>(rate) << " playouts/s] ";
+            ASSERT(mcts.get_iterations() > 0);
+            
+            if (threads == 1) {
+                single_rate = rate;
+            } else if (threads <= cores) {
+                ASSERT(rate >= 0.75 * threads * single_rate);
+            }
+        }
+    }
+}
+
 // ============================================================================
 // Main
 // ============================================================================
@@ -367,23 +1843,65 @@ int main() {
     RUN_TEST(diagonal_win);
     RUN_TEST(anti_diagonal_win);
     RUN_TEST(unmake_move);
+    RUN_TEST(line_mask_win_detection);
+    RUN_TEST(bitboard_ops);
+    RUN_TEST(zobrist_incremental);
+    RUN_TEST(window_codes_incremental);
     
     std::cout << std::endl;
     std::cout << "--- Heuristic Tests ---" << std::endl;
     RUN_TEST(forced_block);
     RUN_TEST(opportunity_preference);
     RUN_TEST(winning_move_detection);
+    RUN_TEST(pattern_table_edges);
+    RUN_TEST(score_cache_consistency);
+    RUN_TEST(top_moves_selection);
+    RUN_TEST(threat_summary);
+    RUN_TEST(four_gains_exact);
+    
+    std::cout << std::endl;
+    std::cout << "--- Solver Tests ---" << std::endl;
+    RUN_TEST(vcf_puzzles);
+    RUN_TEST(vcf_in_mcts);
+    RUN_TEST(vct_puzzles);
+    RUN_TEST(vct_in_mcts);
+    RUN_TEST(dfpn_solver);
+    RUN_TEST(uci_solve);
     
     std::cout << std::endl;
     std::cout << "--- MCTS Tests ---" << std::endl;
     RUN_TEST(mcts_winning_in_one);
     RUN_TEST(mcts_defensive_necessity);
+    RUN_TEST(mcts_forced_short_circuit);
+    RUN_TEST(mcts_solver);
+    RUN_TEST(mcts_solver_widening);
+    RUN_TEST(mcts_puct);
+    RUN_TEST(arena_ranges);
+    RUN_TEST(mcts_tree_reset);
+    RUN_TEST(mcts_subtree_reuse);
+    RUN_TEST(mcts_tree_parallel);
+    RUN_TEST(mcts_root_parallel);
+    RUN_TEST(mcts_transpositions);
+    RUN_TEST(mcts_progressive_widening);
+    RUN_TEST(time_manager);
+    RUN_TEST(mcts_time_extension);
+    RUN_TEST(mcts_solver_time_budget);
+    RUN_TEST(uci_go_clock);
     
     std::cout << std::endl;
     std::cout << "--- Performance Tests ---" << std::endl;
     RUN_TEST(move_performance);
+    RUN_TEST(perft_performance);
+    RUN_TEST(movegen_performance);
+    RUN_TEST(win_check_performance);
     RUN_TEST(heuristic_performance);
+    RUN_TEST(rollout_ply_performance);
+    RUN_TEST(vcf_performance);
+    RUN_TEST(vct_performance);
+    RUN_TEST(dfpn_performance);
+    RUN_TEST(selection_convergence);
     RUN_TEST(mcts_iteration_performance);
+    RUN_TEST(mcts_thread_scaling);
     
     std::cout << std::endl;
     std::cout << "=== All tests passed! ===" << std::endl;